@@ -42,6 +42,9 @@ extern void write_log(char *);
 extern void initialize_sprite(int);
 extern void pre_save_sprite(int);
 extern void get_new_size_for_sprite(int, int, int, int &, int &);
+extern void on_sprite_loading(int);
+extern void on_sprite_loaded(int);
+extern void on_sprite_evicted(int);
 extern int spritewidth[], spriteheight[];
 
 #define SPRITE_LOCKED -1
@@ -209,7 +212,11 @@ Bitmap *SpriteCache::operator [] (int index)
 
   // if sprite exists in file but is not in mem, load it
   if ((images[index] == NULL) && (offsets[index] > 0))
+  {
+    on_sprite_loading(index);
     loadSprite(index);
+    on_sprite_loaded(index);
+  }
 
   // Locked sprite, eg. mouse cursor, that shouldn't be discarded
   if (offsets[index] == SPRITE_LOCKED)
@@ -275,6 +282,7 @@ void SpriteCache::removeOldest()
 
     delete images[sprnum];
     images[sprnum] = NULL;
+    on_sprite_evicted(sprnum);
   }
 
   if (liststart == listend)
@@ -345,7 +353,9 @@ void SpriteCache::precache(int index)
   int sprSize = 0;
 
   if (images[index] == NULL) {
+    on_sprite_loading(index);
     sprSize = loadSprite(index);
+    on_sprite_loaded(index);
   }
   else if (offsets[index] != SPRITE_LOCKED) {
     sprSize = sizes[index];
@@ -17,6 +17,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 #include "alfont.h"
 #include "ac/gamestructdefines.h" //FONT_OUTLINE_AUTO
 #include "font/ttffontrenderer.h"
@@ -57,6 +58,197 @@ ALFONT_FONT *get_ttf_block(wgtfont fontptr)
 #endif // USE_ALFONT
 
 
+// ***** GLYPH CACHE *****
+#ifdef USE_ALFONT
+
+// alfont converts the string, resets the locale and blends each pixel
+// through the Allegro blender on every call, which is slow for the texts
+// redrawn each frame; automatic outlines draw the same text nine times.
+// Therefore each character is rendered by alfont only once, and the text is
+// then blended directly from the cached coverage maps. Blending repeats
+// what alfont does, so the result is the same.
+
+struct TTFGlyph
+{
+  bool cached;
+  int  offx, offy;            // coverage map position relative to the text origin
+  int  width, height;
+  unsigned char *coverage;    // width * height values, 0 means transparent
+};
+
+struct TTFGlyphCache
+{
+  int      advance[256];      // -1 if not measured yet
+  TTFGlyph glyphs[2][256];    // normal and anti-aliased glyphs
+};
+
+TTFGlyphCache *glyphCaches[MAX_FONTS];
+
+// Tells if the text may be drawn with the cached glyphs
+inline bool can_use_glyph_cache(const char *text)
+{
+#ifdef ALFONT_LINUX
+  // Here alfont treats the text as UTF-8, so only ASCII characters are
+  // guaranteed to match the single character glyphs
+  for (; *text; ++text)
+  {
+    if ((unsigned char)*text >= 128)
+      return false;
+  }
+#endif
+  return true;
+}
+
+void free_glyph_cache(int fontNumber)
+{
+  TTFGlyphCache *cache = glyphCaches[fontNumber];
+  if (cache == NULL)
+    return;
+  for (int aa = 0; aa < 2; aa++)
+  {
+    for (int c = 0; c < 256; c++)
+      delete [] cache->glyphs[aa][c].coverage;
+  }
+  delete cache;
+  glyphCaches[fontNumber] = NULL;
+}
+
+TTFGlyphCache *get_glyph_cache(int fontNumber)
+{
+  if (glyphCaches[fontNumber] == NULL)
+  {
+    TTFGlyphCache *cache = new TTFGlyphCache();
+    memset(cache, 0, sizeof(TTFGlyphCache));
+    for (int c = 0; c < 256; c++)
+      cache->advance[c] = -1;
+    glyphCaches[fontNumber] = cache;
+  }
+  return glyphCaches[fontNumber];
+}
+
+int get_glyph_advance(TTFGlyphCache *cache, ALFONT_FONT *alfpt, unsigned char c)
+{
+  if (cache->advance[c] < 0)
+  {
+    char text[2] = { (char)c, 0 };
+    cache->advance[c] = alfont_text_length(alfpt, text);
+  }
+  return cache->advance[c];
+}
+
+const TTFGlyph &get_glyph(TTFGlyphCache *cache, ALFONT_FONT *alfpt, unsigned char c, bool antiAlias)
+{
+  TTFGlyph &glyph = cache->glyphs[antiAlias ? 1 : 0][c];
+  if (glyph.cached)
+    return glyph;
+
+  // Let alfont draw the character in white over black, then the coverage
+  // is the value of any colour component
+  char text[2] = { (char)c, 0 };
+  const int pad = alfont_text_height(alfpt) + 1; // some glyphs stick out of their cell
+  const int bmp_w = get_glyph_advance(cache, alfpt, c) + pad * 2;
+  const int bmp_h = pad * 3;
+  BITMAP *bmp = create_bitmap_ex(32, bmp_w, bmp_h);
+  clear_to_color(bmp, 0);
+  if (antiAlias)
+    alfont_textout_aa_ex(bmp, alfpt, text, pad, pad, 0xFFFFFF, -1);
+  else
+    alfont_textout_ex(bmp, alfpt, text, pad, pad, 0xFFFFFF, -1);
+
+  int left = bmp_w, right = -1, top = bmp_h, bottom = -1;
+  for (int y = 0; y < bmp_h; y++)
+  {
+    const uint32_t *row = (const uint32_t *)bmp->line[y];
+    for (int x = 0; x < bmp_w; x++)
+    {
+      if (row[x] & 0xFF)
+      {
+        if (x < left) left = x;
+        if (x > right) right = x;
+        if (y < top) top = y;
+        if (y > bottom) bottom = y;
+      }
+    }
+  }
+
+  glyph.cached = true;
+  if (right >= 0)
+  {
+    glyph.offx = left - pad;
+    glyph.offy = top - pad;
+    glyph.width = right - left + 1;
+    glyph.height = bottom - top + 1;
+    glyph.coverage = new unsigned char[glyph.width * glyph.height];
+    for (int y = 0; y < glyph.height; y++)
+    {
+      const uint32_t *row = (const uint32_t *)bmp->line[top + y] + left;
+      for (int x = 0; x < glyph.width; x++)
+        glyph.coverage[y * glyph.width + x] = (unsigned char)(row[x] & 0xFF);
+    }
+  }
+  destroy_bitmap(bmp);
+  return glyph;
+}
+
+// Same as __skiptranspixels_blender_trans15/16 in alfont
+inline unsigned long blend_glyph_pixel16(unsigned long x, unsigned long y, unsigned long n,
+                                         unsigned long mask_color, unsigned long bits)
+{
+  if (y == mask_color)
+    return x;
+  n = (n + 1) / 8;
+  x = ((x & 0xFFFF) | (x << 16)) & bits;
+  y = ((y & 0xFFFF) | (y << 16)) & bits;
+  unsigned long result = ((x - y) * n / 32 + y) & bits;
+  return ((result & 0xFFFF) | (result >> 16));
+}
+
+// Same as __preservedalpha_blender_trans24 in alfont
+inline unsigned long blend_glyph_pixel32(unsigned long x, unsigned long y, unsigned long n)
+{
+  const unsigned long alpha = (y & 0xFF000000);
+  if ((y & 0xFFFFFF) == 0xFF00FF)
+    return ((x & 0xFFFFFF) | (n << 24));
+  n++;
+  unsigned long res = ((x & 0xFF00FF) - (y & 0xFF00FF)) * n / 256 + y;
+  unsigned long g = ((x & 0xFF00) - (y & 0xFF00)) * n / 256 + (y & 0xFF00);
+  return (res & 0xFF00FF) | (g & 0xFF00) | alpha;
+}
+
+template <typename TPixel>
+void draw_glyph(BITMAP *bmp, const TTFGlyph &glyph, int x, int y, int colour, int depth)
+{
+  // Clip to the destination's clipping rectangle, like putpixel does
+  int from_x = 0, to_x = glyph.width, from_y = 0, to_y = glyph.height;
+  if (x + from_x < bmp->cl) from_x = bmp->cl - x;
+  if (x + to_x > bmp->cr)   to_x = bmp->cr - x;
+  if (y + from_y < bmp->ct) from_y = bmp->ct - y;
+  if (y + to_y > bmp->cb)   to_y = bmp->cb - y;
+
+  const unsigned long mask_color = depth == 15 ? 0x7C1F : 0xF81F;
+  const unsigned long bits = depth == 15 ? 0x3E07C1F : 0x7E0F81F;
+  for (int gy = from_y; gy < to_y; gy++)
+  {
+    const unsigned char *src = glyph.coverage + gy * glyph.width;
+    TPixel *dst = (TPixel *)bmp->line[y + gy] + x;
+    for (int gx = from_x; gx < to_x; gx++)
+    {
+      const unsigned long alpha = src[gx];
+      if (alpha == 0)
+        continue;
+      if (alpha >= 255)
+        dst[gx] = (TPixel)colour;
+      else if (depth == 32)
+        dst[gx] = (TPixel)blend_glyph_pixel32(colour, dst[gx], alpha);
+      else
+        dst[gx] = (TPixel)blend_glyph_pixel16(colour, dst[gx], alpha, mask_color, bits);
+    }
+  }
+}
+
+#endif // USE_ALFONT
+
+
 // ***** TTF RENDERER *****
 #ifdef USE_ALFONT	// declaration was not under USE_ALFONT though
 
@@ -73,7 +265,15 @@ void TTFFontRenderer::EnsureTextValidForFont(char *text, int fontNumber)
 
 int TTFFontRenderer::GetTextWidth(const char *text, int fontNumber)
 {
-  return alfont_text_length(get_ttf_block(fonts[fontNumber]), text);
+  ALFONT_FONT *alfpt = get_ttf_block(fonts[fontNumber]);
+  if (!can_use_glyph_cache(text))
+    return alfont_text_length(alfpt, text);
+
+  TTFGlyphCache *cache = get_glyph_cache(fontNumber);
+  int width = 0;
+  for (const unsigned char *c = (const unsigned char *)text; *c; ++c)
+    width += get_glyph_advance(cache, alfpt, *c);
+  return width;
 }
 
 int TTFFontRenderer::GetTextHeight(const char *text, int fontNumber)
@@ -87,11 +287,34 @@ void TTFFontRenderer::RenderText(const char *text, int fontNumber, BITMAP *desti
     return;
 
   ALFONT_FONT *alfpt = get_ttf_block(fonts[fontNumber]);
-  // Y - 1 because it seems to get drawn down a bit
-  if ((ShouldAntiAliasText()) && (bitmap_color_depth(destination) > 8))
-    alfont_textout_aa(destination, alfpt, text, x, y - 1, colour);
-  else
-    alfont_textout(destination, alfpt, text, x, y - 1, colour);
+  const int depth = bitmap_color_depth(destination);
+  const bool antiAlias = (ShouldAntiAliasText()) && (depth > 8);
+  if (!can_use_glyph_cache(text) || !is_memory_bitmap(destination) || depth == 24)
+  {
+    // Y - 1 because it seems to get drawn down a bit
+    if (antiAlias)
+      alfont_textout_aa(destination, alfpt, text, x, y - 1, colour);
+    else
+      alfont_textout(destination, alfpt, text, x, y - 1, colour);
+    return;
+  }
+
+  TTFGlyphCache *cache = get_glyph_cache(fontNumber);
+  y--;
+  for (const unsigned char *c = (const unsigned char *)text; *c && x <= destination->cr; ++c)
+  {
+    const TTFGlyph &glyph = get_glyph(cache, alfpt, *c, antiAlias);
+    if (glyph.coverage)
+    {
+      if (depth == 8)
+        draw_glyph<uint8_t>(destination, glyph, x + glyph.offx, y + glyph.offy, colour, depth);
+      else if (depth == 32)
+        draw_glyph<uint32_t>(destination, glyph, x + glyph.offx, y + glyph.offy, colour, depth);
+      else
+        draw_glyph<uint16_t>(destination, glyph, x + glyph.offx, y + glyph.offy, colour, depth);
+    }
+    x += get_glyph_advance(cache, alfpt, *c);
+  }
 }
 
 bool TTFFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
@@ -142,6 +365,8 @@ bool TTFFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
   if (fontSize > 0)
     alfont_set_font_size(alfptr, fontSize);
 
+  free_glyph_cache(fontNumber);
+
   wgtfont tempalloc = (wgtfont) malloc(20);
   strcpy((char *)tempalloc, "TTF");
   memcpy(&((char *)tempalloc)[4], &alfptr, sizeof(alfptr));
@@ -152,6 +377,7 @@ bool TTFFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
 
 void TTFFontRenderer::FreeMemory(int fontNumber)
 {
+  free_glyph_cache(fontNumber);
   alfont_destroy_font(get_ttf_block(fonts[fontNumber]));
   free(fonts[fontNumber]);
   fonts[fontNumber] = NULL;
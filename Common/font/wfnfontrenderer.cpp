@@ -42,6 +42,26 @@ extern int flength_shared(Stream *ffi);
 const char *WFN_FILE_SIGNATURE = "WGT Font File  ";
 WFNFontRenderer wfnRenderer;
 
+const int WFN_CHAR_COUNT = 128;
+
+// WFN characters are stored as bit-packed rows; to avoid decoding them and
+// plotting pixels one by one on each text output, they are expanded on load
+// into byte masks, and scaled up whenever a new text multiplier is in use.
+struct WFNGlyph
+{
+  int width, height;
+  unsigned char *mask;        // width * height values, non-zero for the text pixels
+};
+
+struct WFNGlyphCache
+{
+  WFNGlyph glyphs[WFN_CHAR_COUNT];
+  int      scale;             // multiplier of the scaled glyphs
+  WFNGlyph scaled[WFN_CHAR_COUNT];
+};
+
+WFNGlyphCache *wfnGlyphCaches[MAX_FONTS];
+
 
 void WFNFontRenderer::AdjustYCoordinateForFont(int *ycoord, int fontNumber)
 {
@@ -89,8 +109,132 @@ char* psp_get_char(wgtfont foon, int thisCharacter)
 }
 
 
+inline int get_wfn_char_index(char thisCharacter)
+{
+  if (((unsigned char)thisCharacter >= WFN_CHAR_COUNT))
+    return '?';
+  return thisCharacter;
+}
+
+void free_wfn_glyphs(WFNGlyph *glyphs)
+{
+  for (int i = 0; i < WFN_CHAR_COUNT; i++)
+  {
+    delete [] glyphs[i].mask;
+    glyphs[i].mask = NULL;
+  }
+}
+
+void free_wfn_glyph_cache(int fontNumber)
+{
+  WFNGlyphCache *cache = wfnGlyphCaches[fontNumber];
+  if (cache == NULL)
+    return;
+  free_wfn_glyphs(cache->glyphs);
+  free_wfn_glyphs(cache->scaled);
+  delete cache;
+  wfnGlyphCaches[fontNumber] = NULL;
+}
+
+void create_wfn_glyph_cache(int fontNumber)
+{
+  wgtfont foon = fonts[fontNumber];
+  WFNGlyphCache *cache = new WFNGlyphCache();
+  memset(cache, 0, sizeof(WFNGlyphCache));
+
+  for (int charr = 0; charr < WFN_CHAR_COUNT; charr++)
+  {
+    char* tabaddr = psp_get_char(foon, charr);
+    short tabaddr_d;
+    memcpy(&tabaddr_d, (char*)((long)tabaddr), 2);
+#if defined (AGS_BIG_ENDIAN)
+    AGS::Common::BitByteOperations::SwapBytesInt16(tabaddr_d);
+#endif
+    const int charWidth = tabaddr_d;
+    memcpy(&tabaddr_d, (char*)((long)tabaddr + 2), 2);
+#if defined (AGS_BIG_ENDIAN)
+    AGS::Common::BitByteOperations::SwapBytesInt16(tabaddr_d);
+#endif
+    const int charHeight = tabaddr_d;
+
+    WFNGlyph &glyph = cache->glyphs[charr];
+    glyph.width = charWidth;
+    glyph.height = charHeight;
+    if (charWidth <= 0 || charHeight <= 0)
+      continue;
+
+    const unsigned char *actdata = (unsigned char *)&tabaddr[2*2];
+    const int bytewid = ((charWidth - 1) / 8) + 1;
+    glyph.mask = new unsigned char[charWidth * charHeight];
+    for (int tt = 0; tt < charHeight; tt++) {
+      for (int ss = 0; ss < charWidth; ss++)
+        glyph.mask[tt * charWidth + ss] = (actdata[tt * bytewid + (ss / 8)] & (0x80 >> (ss % 8))) != 0;
+    }
+  }
+  wfnGlyphCaches[fontNumber] = cache;
+}
+
+// Gets glyphs scaled by the current text multiplier
+const WFNGlyph *get_wfn_glyphs(WFNGlyphCache *cache)
+{
+  if (wtext_multiply <= 1)
+    return cache->glyphs;
+  if (cache->scale == wtext_multiply)
+    return cache->scaled;
+
+  free_wfn_glyphs(cache->scaled);
+  const int mul = wtext_multiply;
+  for (int charr = 0; charr < WFN_CHAR_COUNT; charr++)
+  {
+    const WFNGlyph &glyph = cache->glyphs[charr];
+    WFNGlyph &scaled = cache->scaled[charr];
+    scaled.width = glyph.width * mul;
+    scaled.height = glyph.height * mul;
+    if (!glyph.mask)
+      continue;
+    scaled.mask = new unsigned char[scaled.width * scaled.height];
+    for (int yy = 0; yy < scaled.height; yy++) {
+      for (int xx = 0; xx < scaled.width; xx++)
+        scaled.mask[yy * scaled.width + xx] = glyph.mask[(yy / mul) * glyph.width + xx / mul];
+    }
+  }
+  cache->scale = mul;
+  return cache->scaled;
+}
+
+template <typename TPixel>
+void draw_wfn_glyph(BITMAP *bmp, const WFNGlyph &glyph, int x, int y, int colour)
+{
+  // Clip to the destination's clipping rectangle, like putpixel and rectfill do
+  int from_x = 0, to_x = glyph.width, from_y = 0, to_y = glyph.height;
+  if (x + from_x < bmp->cl) from_x = bmp->cl - x;
+  if (x + to_x > bmp->cr)   to_x = bmp->cr - x;
+  if (y + from_y < bmp->ct) from_y = bmp->ct - y;
+  if (y + to_y > bmp->cb)   to_y = bmp->cb - y;
+
+  for (int gy = from_y; gy < to_y; gy++)
+  {
+    const unsigned char *src = glyph.mask + gy * glyph.width;
+    TPixel *dst = (TPixel *)bmp->line[y + gy] + x;
+    for (int gx = from_x; gx < to_x; gx++)
+    {
+      if (src[gx])
+        dst[gx] = (TPixel)colour;
+    }
+  }
+}
+
 int WFNFontRenderer::GetTextWidth(const char *texx, int fontNumber)
 {
+  if (wfnGlyphCaches[fontNumber])
+  {
+    const WFNGlyph *glyphs = wfnGlyphCaches[fontNumber]->glyphs;
+    int totlen = 0;
+    for (; *texx; ++texx)
+      totlen += glyphs[get_wfn_char_index(*texx)].width;
+    return totlen * wtext_multiply;
+  }
+
   wgtfont foon = fonts[fontNumber];
 
   int totlen = 0;
@@ -117,6 +261,19 @@ int WFNFontRenderer::GetTextWidth(const char *texx, int fontNumber)
 
 int WFNFontRenderer::GetTextHeight(const char *texx, int fontNumber)
 {
+  if (wfnGlyphCaches[fontNumber])
+  {
+    const WFNGlyph *glyphs = wfnGlyphCaches[fontNumber]->glyphs;
+    int highest = 0;
+    for (; *texx; ++texx)
+    {
+      const int charHeight = glyphs[get_wfn_char_index(*texx)].height;
+      if (charHeight > highest)
+        highest = charHeight;
+    }
+    return highest * wtext_multiply;
+  }
+
   int highest = 0;
   unsigned int dd;
   wgtfont foon = fonts[fontNumber];
@@ -150,6 +307,29 @@ void WFNFontRenderer::RenderText(const char *text, int fontNumber, BITMAP *desti
   int oldeip = get_our_eip();
   set_our_eip(415);
 
+  const int depth = bitmap_color_depth(destination);
+  if (wfnGlyphCaches[fontNumber] && is_memory_bitmap(destination) && depth != 24)
+  {
+    // Copy the expanded glyphs directly to the bitmap
+    const WFNGlyph *glyphs = get_wfn_glyphs(wfnGlyphCaches[fontNumber]);
+    for (; *text; ++text)
+    {
+      const WFNGlyph &glyph = glyphs[get_wfn_char_index(*text)];
+      if (glyph.mask)
+      {
+        if (depth == 8)
+          draw_wfn_glyph<uint8_t>(destination, glyph, x, y, colour);
+        else if (depth == 32)
+          draw_wfn_glyph<uint32_t>(destination, glyph, x, y, colour);
+        else
+          draw_wfn_glyph<uint16_t>(destination, glyph, x, y, colour);
+      }
+      x += glyph.width;
+    }
+    set_our_eip(oldeip);
+    return;
+  }
+
   render_wrapper.WrapAllegroBitmap(destination, true);
 
   for (ee = 0; ee < strlen(text); ee++)
@@ -242,11 +422,14 @@ bool WFNFontRenderer::LoadFromDisk(int fontNumber, int fontSize)
   delete ffi;
 
   fonts[fontNumber] = tempalloc;
+  free_wfn_glyph_cache(fontNumber);
+  create_wfn_glyph_cache(fontNumber);
   return true;
 }
 
 void WFNFontRenderer::FreeMemory(int fontNumber)
 {
+  free_wfn_glyph_cache(fontNumber);
   free(fonts[fontNumber]);
   fonts[fontNumber] = NULL;
 }
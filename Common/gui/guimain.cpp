@@ -67,6 +67,7 @@ void GUIMain::init()
   fgcol = 1;
   bgcol = 8;
   flags = 0;
+  changed = true;
 }
 
 void GUIMain::FixupGuiName(char* name)
@@ -384,6 +385,30 @@ void GUIMain::control_positions_changed()
   mousewasy = -1;
 }
 
+void GUIMain::mark_changed()
+{
+  changed = true;
+}
+
+bool GUIMain::has_changed()
+{
+  if (changed)
+    return true;
+  for (int i = 0; i < numobjs; i++)
+  {
+    if (objs[i]->IsChanged())
+      return true;
+  }
+  return false;
+}
+
+void GUIMain::clear_changed()
+{
+  changed = false;
+  for (int i = 0; i < numobjs; i++)
+    objs[i]->ClearChanged();
+}
+
 void GUIMain::poll()
 {
   int mxwas = mousex, mywas = mousey;
@@ -413,7 +438,7 @@ void GUIMain::poll()
           objs[mouseover]->MouseMove(mousex, mousey);
         }
       }
-      guis_need_update = 1;
+      mark_changed();
     } 
     else if (mouseover >= 0)
       objs[mouseover]->MouseMove(mousex, mousey);
@@ -438,7 +463,7 @@ void GUIMain::mouse_but_down()
   if (objs[mouseover]->MouseDown())
     mouseover = MOVER_MOUSEDOWNLOCKED;
   objs[mousedownon]->MouseMove(mousex - x, mousey - y);
-  guis_need_update = 1;
+  mark_changed();
 }
 
 void GUIMain::mouse_but_up()
@@ -455,7 +480,7 @@ void GUIMain::mouse_but_up()
 
   objs[mousedownon]->MouseUp();
   mousedownon = -1;
-  guis_need_update = 1;
+  mark_changed();
 }
 
 GuiVersion GameGuiVersion = kGuiVersion_Initial;
@@ -59,6 +59,7 @@ struct GUIMain
   GUIObject *objs[MAX_OBJS_ON_GUI];
   int objrefptr[MAX_OBJS_ON_GUI];       // for re-building objs array
   short drawOrder[MAX_OBJS_ON_GUI];
+  bool changed;                 // GUI must be redrawn (not saved)
 
   static char oNameBuffer[20];
 
@@ -84,6 +85,11 @@ struct GUIMain
   bool bring_to_front(int objNum);
   void control_positions_changed();
   bool is_alpha();
+  // Marks the GUI itself for redraw
+  void mark_changed();
+  // Tells whether the GUI or any of its controls need redraw
+  bool has_changed();
+  void clear_changed();
 
   void FixupGuiName(char* name);
   void SetTransparencyAsPercentage(int percent);
@@ -26,6 +26,7 @@ void GUIObject::init() {
   scriptName[0] = 0;
   for (jj = 0; jj < MAX_GUIOBJ_EVENTS; jj++)
     eventHandlers[jj][0] = 0;
+  changed = true;
 }
 
 int GUIObject::IsDisabled() {
@@ -56,6 +56,8 @@ struct GUIObject
   char scriptName[MAX_GUIOBJ_SCRIPTNAME_LEN + 1];
   char eventHandlers[MAX_GUIOBJ_EVENTS][MAX_GUIOBJ_EVENTHANDLER_LEN + 1];
 
+  GUIObject() : changed(true) { }
+
   virtual void MouseMove(int, int) = 0; // x,y relative to gui
   virtual void MouseOver() = 0; // mouse moves onto object
   virtual void MouseLeave() = 0;        // mouse moves off object
@@ -124,10 +126,22 @@ struct GUIObject
      return (flags & GUIF_TRANSLATED) != 0;
   }
 
+  // Tells that the control's look has changed and its GUI must be redrawn
+  void MarkChanged() {
+    changed = true;
+  }
+  bool IsChanged() const {
+    return changed;
+  }
+  void ClearChanged() {
+    changed = false;
+  }
+
 protected:
   const char *supportedEvents[MAX_GUIOBJ_EVENTS];
   const char *supportedEventArgs[MAX_GUIOBJ_EVENTS];
   int numSupportedEvents;
+  bool changed;
 };
 
 #endif // __AC_GUIOBJECT_H
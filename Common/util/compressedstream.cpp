@@ -0,0 +1,281 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <string.h>
+#include "util/compressedstream.h"
+#include "util/lz4.h"
+#include "util/math.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+// Largest amount of uncompressed data in one block
+const size_t CompressedBlockSize = 64 * 1024;
+
+CompressedStream::CompressedStream(Stream *stream, FileWorkMode work_mode,
+                                   ObjectOwnershipPolicy stream_ownership_policy, bool compress)
+    : DataStream(kLittleEndian)
+    , _stream(stream)
+    , _streamOwnershipPolicy(stream_ownership_policy)
+    , _workMode(work_mode)
+    , _compress(compress)
+    , _bufferLength(0)
+    , _bufferPos(0)
+    , _position(0)
+    , _failed(false)
+{
+    _buffer = new uint8_t[CompressedBlockSize];
+    _packBuffer = new uint8_t[lz4_compress_bound(CompressedBlockSize)];
+}
+
+CompressedStream::~CompressedStream()
+{
+    Close();
+}
+
+bool CompressedStream::PackBlocks(Stream *in, Stream *out)
+{
+    CompressedStream reader(in, kFile_Read);
+    CompressedStream writer(out, kFile_Write);
+    // Every block is copied as a whole, so the block boundaries stay
+    while (reader.ReadBlock())
+    {
+        memcpy(writer._buffer, reader._buffer, reader._bufferLength);
+        writer._bufferLength = reader._bufferLength;
+        if (!writer.WriteBlock())
+        {
+            return false;
+        }
+    }
+    // Reading stops at the end of the stream, or at a malformed block
+    return in->EOS();
+}
+
+void CompressedStream::Close()
+{
+    if (_stream && CanWrite())
+    {
+        WriteBlock();
+    }
+    if (_stream && _streamOwnershipPolicy == kDisposeAfterUse)
+    {
+        delete _stream;
+    }
+    _stream = NULL;
+    delete [] _buffer;
+    _buffer = NULL;
+    delete [] _packBuffer;
+    _packBuffer = NULL;
+}
+
+bool CompressedStream::Flush()
+{
+    if (!CanWrite())
+    {
+        return CanRead();
+    }
+    return WriteBlock() && _stream->Flush();
+}
+
+bool CompressedStream::IsValid() const
+{
+    return _stream && _stream->IsValid() && !_failed;
+}
+
+bool CompressedStream::EOS() const
+{
+    if (!IsValid())
+    {
+        return true;
+    }
+    return CanRead() && _bufferPos == _bufferLength && _stream->EOS();
+}
+
+size_t CompressedStream::GetLength() const
+{
+    // Not known until all of the data is passed
+    return 0;
+}
+
+size_t CompressedStream::GetPosition() const
+{
+    return _position;
+}
+
+bool CompressedStream::CanRead() const
+{
+    return _stream && _workMode == kFile_Read;
+}
+
+bool CompressedStream::CanWrite() const
+{
+    return _stream && _workMode == kFile_Write;
+}
+
+bool CompressedStream::CanSeek() const
+{
+    return false;
+}
+
+size_t CompressedStream::Read(void *buffer, size_t size)
+{
+    if (!CanRead() || !buffer)
+    {
+        return 0;
+    }
+
+    uint8_t *dst = (uint8_t*)buffer;
+    size_t read = 0;
+    while (read < size)
+    {
+        // The next block is only read when more data is actually requested
+        if (_bufferPos == _bufferLength && !ReadBlock())
+        {
+            break;
+        }
+        size_t chunk = Math::Min(size - read, _bufferLength - _bufferPos);
+        memcpy(dst + read, _buffer + _bufferPos, chunk);
+        _bufferPos += chunk;
+        read += chunk;
+    }
+    _position += read;
+    return read;
+}
+
+int32_t CompressedStream::ReadByte()
+{
+    uint8_t b;
+    return Read(&b, 1) == 1 ? b : -1;
+}
+
+size_t CompressedStream::Write(const void *buffer, size_t size)
+{
+    if (!CanWrite() || !buffer)
+    {
+        return 0;
+    }
+
+    const uint8_t *src = (const uint8_t*)buffer;
+    size_t written = 0;
+    while (written < size)
+    {
+        if (_bufferLength == CompressedBlockSize && !WriteBlock())
+        {
+            break;
+        }
+        size_t chunk = Math::Min(size - written, CompressedBlockSize - _bufferLength);
+        memcpy(_buffer + _bufferLength, src + written, chunk);
+        _bufferLength += chunk;
+        written += chunk;
+    }
+    _position += written;
+    return written;
+}
+
+int32_t CompressedStream::WriteByte(uint8_t b)
+{
+    return Write(&b, 1) == 1 ? b : -1;
+}
+
+size_t CompressedStream::Seek(StreamSeek seek, int pos)
+{
+    if (!CanRead() || seek != kSeekCurrent || pos < 0)
+    {
+        // Not supported
+        return 0;
+    }
+
+    size_t skip = pos;
+    while (skip > 0)
+    {
+        if (_bufferPos == _bufferLength && !ReadBlock())
+        {
+            break;
+        }
+        size_t chunk = Math::Min(skip, _bufferLength - _bufferPos);
+        _bufferPos += chunk;
+        _position += chunk;
+        skip -= chunk;
+    }
+    return _position;
+}
+
+bool CompressedStream::ReadBlock()
+{
+    _bufferLength = 0;
+    _bufferPos = 0;
+    if (_failed)
+    {
+        return false;
+    }
+
+    // Block header: uncompressed length and compressed length; equal
+    // lengths mean that the block is stored uncompressed
+    int32_t length = _stream->ReadInt32();
+    int32_t pack_length = _stream->ReadInt32();
+    if (length <= 0 || (size_t)length > CompressedBlockSize ||
+        pack_length <= 0 || pack_length > length)
+    {
+        _failed = true;
+        return false;
+    }
+
+    if (pack_length == length)
+    {
+        _failed = _stream->Read(_buffer, length) != (size_t)length;
+    }
+    else
+    {
+        _failed = _stream->Read(_packBuffer, pack_length) != (size_t)pack_length ||
+            !lz4_decompress(_packBuffer, pack_length, _buffer, length);
+    }
+    if (_failed)
+    {
+        return false;
+    }
+    _bufferLength = length;
+    return true;
+}
+
+bool CompressedStream::WriteBlock()
+{
+    if (_failed)
+    {
+        return false;
+    }
+    if (_bufferLength == 0)
+    {
+        return true;
+    }
+
+    size_t pack_length = _compress ? lz4_compress(_buffer, _bufferLength, _packBuffer) : _bufferLength;
+    _stream->WriteInt32(_bufferLength);
+    if (pack_length < _bufferLength)
+    {
+        _stream->WriteInt32(pack_length);
+        _failed = _stream->Write(_packBuffer, pack_length) != pack_length;
+    }
+    else
+    {
+        _stream->WriteInt32(_bufferLength);
+        _failed = _stream->Write(_buffer, _bufferLength) != _bufferLength;
+    }
+    _bufferLength = 0;
+    return !_failed;
+}
+
+} // namespace Common
+} // namespace AGS
@@ -0,0 +1,104 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Stream which compresses the data written to another stream, or
+// decompresses the data read from it.
+//
+// The data is split into blocks of up to 64 KB, each compressed separately
+// and preceded by its uncompressed and compressed sizes. Flush ends the
+// current block early; the reader never reads past the block it needs, so
+// after reading all the data written before a Flush the wrapped stream is
+// positioned right after that block, and may be used directly.
+//
+// The writer may also store the blocks uncompressed, leaving compression
+// to PackBlocks, which may be run later on another thread.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__COMPRESSEDSTREAM_H
+#define __AGS_CN_UTIL__COMPRESSEDSTREAM_H
+
+#include "util/datastream.h"
+#include "util/file.h"
+#include "util/proxystream.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class CompressedStream : public DataStream
+{
+public:
+    // Wraps the stream for either reading or writing; if compress is false,
+    // the blocks are written uncompressed
+    CompressedStream(Stream *stream, FileWorkMode work_mode,
+        ObjectOwnershipPolicy stream_ownership_policy = kReleaseAfterUse, bool compress = true);
+    virtual ~CompressedStream();
+
+    // Copies the blocks till the end of one stream to another, compressing
+    // them anew; returns false if the blocks are malformed or could not be
+    // written
+    static bool     PackBlocks(Stream *in, Stream *out);
+
+    // Returns the wrapped stream
+    inline Stream  *GetBaseStream() const
+    {
+        return _stream;
+    }
+
+    // Writes the rest of data and releases the wrapped stream
+    virtual void    Close();
+    // Writes the buffered data as a complete block
+    virtual bool    Flush();
+
+    // Is stream valid (underlying data initialized properly)
+    virtual bool    IsValid() const;
+    // Is end of stream
+    virtual bool    EOS() const;
+    // Total length of stream (if known)
+    virtual size_t  GetLength() const;
+    // Current position (if known)
+    virtual size_t  GetPosition() const;
+    virtual bool    CanRead() const;
+    virtual bool    CanWrite() const;
+    virtual bool    CanSeek() const;
+
+    virtual size_t  Read(void *buffer, size_t size);
+    virtual int32_t ReadByte();
+    virtual size_t  Write(const void *buffer, size_t size);
+    virtual int32_t WriteByte(uint8_t b);
+
+    // Only skipping forward is supported
+    virtual size_t  Seek(StreamSeek seek, int pos);
+
+private:
+    bool            ReadBlock();
+    bool            WriteBlock();
+
+    Stream                  *_stream;
+    ObjectOwnershipPolicy   _streamOwnershipPolicy;
+    const FileWorkMode      _workMode;
+    const bool              _compress;
+    uint8_t                 *_buffer;       // uncompressed data of the current block
+    size_t                  _bufferLength;  // amount of data in the buffer
+    size_t                  _bufferPos;     // read position in the buffer
+    uint8_t                 *_packBuffer;   // compressed data of the current block
+    size_t                  _position;      // total uncompressed data passed
+    bool                    _failed;        // block could not be read or written
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__COMPRESSEDSTREAM_H
@@ -0,0 +1,182 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <string.h>
+#include "util/lz4.h"
+
+// Every sequence is a token byte, which holds literal and match lengths,
+// followed by the literals, 16-bit match offset and the extra length bytes.
+// The last sequence has literals only.
+const size_t LZ4_MIN_MATCH     = 4;
+// The last match must start this far from the end of block...
+const size_t LZ4_MATCH_LIMIT   = 12;
+// ...and the last bytes of block are always literals
+const size_t LZ4_LAST_LITERALS = 5;
+const size_t LZ4_MAX_OFFSET    = 65535;
+const int    LZ4_HASH_BITS     = 12;
+
+inline uint32_t lz4_read32(const uint8_t *p)
+{
+    uint32_t val;
+    memcpy(&val, p, sizeof(val));
+    return val;
+}
+
+inline uint32_t lz4_hash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+inline uint8_t *lz4_write_length(uint8_t *op, size_t length)
+{
+    for (; length >= 255; length -= 255)
+        *op++ = 255;
+    *op++ = (uint8_t)length;
+    return op;
+}
+
+inline uint8_t *lz4_write_literals(uint8_t *op, uint8_t *token, const uint8_t *literals, size_t length)
+{
+    *token = (uint8_t)((length < 15 ? length : 15) << 4);
+    if (length >= 15)
+        op = lz4_write_length(op, length - 15);
+    memcpy(op, literals, length);
+    return op + length;
+}
+
+size_t lz4_compress_bound(size_t src_size)
+{
+    return src_size + src_size / 255 + 16;
+}
+
+size_t lz4_compress(const uint8_t *src, size_t src_size, uint8_t *dst)
+{
+    const uint8_t *ip = src;
+    const uint8_t *anchor = src;
+    const uint8_t *src_end = src + src_size;
+    uint8_t *op = dst;
+
+    if (src_size > LZ4_MATCH_LIMIT)
+    {
+        // Last position of every 4-byte sequence seen, relative to src
+        uint32_t table[1 << LZ4_HASH_BITS];
+        memset(table, 0, sizeof(table));
+
+        const uint8_t *match_limit = src_end - LZ4_MATCH_LIMIT;
+        const uint8_t *match_end_limit = src_end - LZ4_LAST_LITERALS;
+        while (ip <= match_limit)
+        {
+            const uint32_t sequence = lz4_read32(ip);
+            const uint32_t hash = lz4_hash(sequence);
+            const uint8_t *ref = src + table[hash];
+            table[hash] = (uint32_t)(ip - src);
+            if (ref >= ip || (size_t)(ip - ref) > LZ4_MAX_OFFSET || lz4_read32(ref) != sequence)
+            {
+                // Move faster through data which does not compress
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            const uint8_t *match_end = ip + LZ4_MIN_MATCH;
+            for (const uint8_t *rp = ref + LZ4_MIN_MATCH; match_end < match_end_limit && *match_end == *rp; ++rp)
+                ++match_end;
+
+            uint8_t *token = op++;
+            op = lz4_write_literals(op, token, anchor, ip - anchor);
+            const size_t offset = ip - ref;
+            *op++ = (uint8_t)(offset & 0xFF);
+            *op++ = (uint8_t)(offset >> 8);
+            const size_t match_length = match_end - ip - LZ4_MIN_MATCH;
+            *token |= (uint8_t)(match_length < 15 ? match_length : 15);
+            if (match_length >= 15)
+                op = lz4_write_length(op, match_length - 15);
+
+            ip = anchor = match_end;
+            table[lz4_hash(lz4_read32(ip - 2))] = (uint32_t)(ip - 2 - src);
+        }
+    }
+
+    uint8_t *token = op++;
+    op = lz4_write_literals(op, token, anchor, src_end - anchor);
+    return op - dst;
+}
+
+bool lz4_decompress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size)
+{
+    const uint8_t *ip = src;
+    const uint8_t *src_end = src + src_size;
+    uint8_t *op = dst;
+    uint8_t *dst_end = dst + dst_size;
+
+    while (ip < src_end)
+    {
+        const uint8_t token = *ip++;
+        size_t length = token >> 4;
+        if (length == 15)
+        {
+            uint8_t b;
+            do
+            {
+                if (ip == src_end)
+                    return false;
+                b = *ip++;
+                length += b;
+            }
+            while (b == 255);
+        }
+        if ((size_t)(src_end - ip) < length || (size_t)(dst_end - op) < length)
+            return false;
+        memcpy(op, ip, length);
+        op += length;
+        ip += length;
+        if (ip == src_end)
+            break; // last sequence has no match
+
+        if (src_end - ip < 2)
+            return false;
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst))
+            return false;
+        length = token & 15;
+        if (length == 15)
+        {
+            uint8_t b;
+            do
+            {
+                if (ip == src_end)
+                    return false;
+                b = *ip++;
+                length += b;
+            }
+            while (b == 255);
+        }
+        length += LZ4_MIN_MATCH;
+        if ((size_t)(dst_end - op) < length)
+            return false;
+        const uint8_t *match = op - offset;
+        if (offset >= length)
+        {
+            memcpy(op, match, length);
+            op += length;
+        }
+        else
+        {
+            // Overlapping match repeats the last bytes
+            for (; length > 0; --length)
+                *op++ = *match++;
+        }
+    }
+    return op == dst_end;
+}
@@ -0,0 +1,35 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Fast compression of memory blocks in the LZ4 block format.
+//
+// The functions keep no state between calls and may be used from several
+// threads at once.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__LZ4_H
+#define __AGS_CN_UTIL__LZ4_H
+
+#include "core/types.h"
+
+// Maximal size of the compressed data for the input of given size
+size_t lz4_compress_bound(size_t src_size);
+// Compresses the block into dst, which must have at least
+// lz4_compress_bound(src_size) bytes; returns the compressed size
+size_t lz4_compress(const uint8_t *src, size_t src_size, uint8_t *dst);
+// Decompresses the block, which must expand to exactly dst_size bytes;
+// returns false if the compressed data is malformed
+bool   lz4_decompress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size);
+
+#endif // __AGS_CN_UTIL__LZ4_H
@@ -0,0 +1,169 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include "util/memorystream.h"
+#include "util/math.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+MemoryStream::MemoryStream(DataEndianess stream_endianess)
+    : DataStream(stream_endianess)
+    , _buffer(NULL)
+    , _capacity(0)
+    , _length(0)
+    , _position(0)
+{
+}
+
+MemoryStream::~MemoryStream()
+{
+    Close();
+}
+
+void MemoryStream::Clear()
+{
+    _length = 0;
+    _position = 0;
+}
+
+void MemoryStream::Close()
+{
+    free(_buffer);
+    _buffer = NULL;
+    _capacity = 0;
+    _length = 0;
+    _position = 0;
+}
+
+bool MemoryStream::Flush()
+{
+    return true;
+}
+
+bool MemoryStream::IsValid() const
+{
+    return true;
+}
+
+bool MemoryStream::EOS() const
+{
+    return _position >= _length;
+}
+
+size_t MemoryStream::GetLength() const
+{
+    return _length;
+}
+
+size_t MemoryStream::GetPosition() const
+{
+    return _position;
+}
+
+bool MemoryStream::CanRead() const
+{
+    return true;
+}
+
+bool MemoryStream::CanWrite() const
+{
+    return true;
+}
+
+bool MemoryStream::CanSeek() const
+{
+    return true;
+}
+
+size_t MemoryStream::Read(void *buffer, size_t size)
+{
+    if (!buffer || _position >= _length)
+    {
+        return 0;
+    }
+    size = Math::Min(size, _length - _position);
+    memcpy(buffer, _buffer + _position, size);
+    _position += size;
+    return size;
+}
+
+int32_t MemoryStream::ReadByte()
+{
+    if (_position >= _length)
+    {
+        return -1;
+    }
+    return _buffer[_position++];
+}
+
+size_t MemoryStream::Write(const void *buffer, size_t size)
+{
+    if (!buffer || !Reserve(_position + size))
+    {
+        return 0;
+    }
+    memcpy(_buffer + _position, buffer, size);
+    _position += size;
+    _length = Math::Max(_length, _position);
+    return size;
+}
+
+int32_t MemoryStream::WriteByte(uint8_t b)
+{
+    return Write(&b, 1) == 1 ? b : -1;
+}
+
+size_t MemoryStream::Seek(StreamSeek seek, int pos)
+{
+    int base;
+    switch (seek)
+    {
+    case kSeekBegin:    base = 0; break;
+    case kSeekCurrent:  base = _position; break;
+    case kSeekEnd:      base = _length; break;
+    default:
+        return 0;
+    }
+    const int length = _length;
+    _position = Math::Clamp<int>(0, length, base + pos);
+    return _position;
+}
+
+bool MemoryStream::Reserve(size_t capacity)
+{
+    if (capacity <= _capacity)
+    {
+        return true;
+    }
+    // Grow by half at least, so that many small writes do not reallocate
+    // the buffer every time
+    capacity = Math::Max(capacity, _capacity + _capacity / 2);
+    capacity = Math::Max<size_t>(capacity, 4096);
+    uint8_t *buffer = (uint8_t*)realloc(_buffer, capacity);
+    if (!buffer)
+    {
+        return false;
+    }
+    _buffer = buffer;
+    _capacity = capacity;
+    return true;
+}
+
+} // namespace Common
+} // namespace AGS
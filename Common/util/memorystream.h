@@ -0,0 +1,77 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Stream over a memory buffer, which grows as the data is written.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__MEMORYSTREAM_H
+#define __AGS_CN_UTIL__MEMORYSTREAM_H
+
+#include "util/datastream.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class MemoryStream : public DataStream
+{
+public:
+    MemoryStream(DataEndianess stream_endianess = kLittleEndian);
+    virtual ~MemoryStream();
+
+    // Returns the buffer with the data; it is only valid until the next write
+    inline const uint8_t *GetData() const
+    {
+        return _buffer;
+    }
+    // Removes all data and moves to the beginning, keeping the allocated memory
+    void            Clear();
+
+    // Frees the memory
+    virtual void    Close();
+    virtual bool    Flush();
+
+    // Is stream valid (underlying data initialized properly)
+    virtual bool    IsValid() const;
+    // Is end of stream
+    virtual bool    EOS() const;
+    // Total length of stream (if known)
+    virtual size_t  GetLength() const;
+    // Current position (if known)
+    virtual size_t  GetPosition() const;
+    virtual bool    CanRead() const;
+    virtual bool    CanWrite() const;
+    virtual bool    CanSeek() const;
+
+    virtual size_t  Read(void *buffer, size_t size);
+    virtual int32_t ReadByte();
+    virtual size_t  Write(const void *buffer, size_t size);
+    virtual int32_t WriteByte(uint8_t b);
+
+    virtual size_t  Seek(StreamSeek seek, int pos);
+
+private:
+    bool            Reserve(size_t capacity);
+
+    uint8_t *_buffer;
+    size_t  _capacity;
+    size_t  _length;
+    size_t  _position;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__MEMORYSTREAM_H
@@ -468,6 +468,10 @@ managed struct Game {
   import static void   SetAudioTypeSpeechVolumeDrop(AudioType, int volumeDrop);
   /// Changes the default volume of audio clips of the specified type.
   import static void   SetAudioTypeVolume(AudioType, int volume, ChangeVolumeType);
+  /// Restores the game from a snapshot kept in memory; 0 is the most recent one.
+  import static void   RestoreSnapshot(int index=0);
+  /// Saves the game state into a snapshot kept in memory.
+  import static void   SaveSnapshot();
   /// Sets the directory where AGS will save and load saved games.
   import static bool   SetSaveGameDirectory(const string directory);
   /// Stops all currently playing audio (optionally of the specified type).
@@ -506,6 +510,8 @@ managed struct Game {
   import static attribute FontType NormalFont;
   /// Checks whether the game is currently skipping over a cutscene.
   readonly import static attribute bool SkippingCutscene;
+  /// Gets the number of game snapshots kept in memory.
+  readonly import static attribute int SnapshotCount;
   /// Gets/sets the font used for displaying speech text.
   import static attribute FontType SpeechFont;
   /// Gets the height of the specified sprite.
@@ -1312,7 +1318,9 @@ enum EventType {
   eEventGUIMouseUp = 6,
   eEventAddInventory = 7,
   eEventLoseInventory = 8,
-  eEventRestoreGame = 9
+  eEventRestoreGame = 9,
+  eEventSaveGame = 10,
+  eEventSaveGameFailed = 11
 };
 
 // forward-declare these so that they can be returned by GUIControl class
@@ -161,6 +161,10 @@ void pre_save_sprite(int spnum) {
   fix_sprite(spnum);
 }
 
+void on_sprite_loading(int spnum) { }
+void on_sprite_loaded(int spnum) { }
+void on_sprite_evicted(int spnum) { }
+
 Common::Bitmap *get_sprite (int spnr) {
   if (spnr < 0)
     return NULL;
@@ -0,0 +1,258 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "ac/asyncsave.h"
+
+#if defined(WINDOWS_VERSION) || defined(LINUX_VERSION) || defined(MAC_VERSION) || \
+    defined(IOS_VERSION) || defined(ANDROID_VERSION)
+#define AGS_HAS_ASYNC_SAVE
+#endif
+
+#if defined(AGS_HAS_ASYNC_SAVE)
+
+#if defined(WINDOWS_VERSION)
+#include <io.h>
+#include <winalleg.h>
+#else
+#include <unistd.h> // for unlink()
+#endif
+#include <stdio.h>
+#include <string.h>
+#include "util/wgt2allg.h"
+#include "ac/game.h"
+#include "ac/gamesetup.h"
+#include "debug/out.h"
+#include "debug/tracer.h"
+#include "gfx/bitmap.h"
+#include "plugin/agsplugin.h"
+#include "util/file.h"
+#include "util/memorystream.h"
+#include "util/mutex_lock.h"
+#include "util/semaphore.h"
+#include "util/string.h"
+#include "util/thread.h"
+
+using AGS::Common::Bitmap;
+using AGS::Common::MemoryStream;
+using AGS::Common::String;
+using AGS::Engine::Mutex;
+using AGS::Engine::MutexLock;
+using AGS::Engine::Semaphore;
+using AGS::Engine::Thread;
+namespace Out = AGS::Common::Out;
+
+extern GameSetup usetup;
+extern char saveGameDirectory[260];
+extern color palette[256];
+
+struct AsyncSaveJob
+{
+    String        Path;         // the slot's file
+    String        TempPath;     // file written before it replaces the slot's one
+    int           Slot;
+    MemoryStream *Image;        // saved game as save_game made it
+    size_t        DataOffset;   // where the data to compress starts in the image
+    Bitmap       *Screenshot;
+    color         Palette[256];
+    bool          Success;
+    bool          Done;         // saving thread has finished with the job
+    Semaphore     Finished;
+};
+
+Thread        saver_thread;
+int           saver_state = -1; // -1 not started, 0 not available, 1 running
+volatile bool saver_quit = false;
+Mutex         saver_mutex;
+Semaphore     saver_wake;
+AsyncSaveJob *saver_job = NULL;     // job handed to the saving thread
+// The last job, until the script is told about it; used only on the main thread
+AsyncSaveJob *pending_save = NULL;
+
+bool replace_file(const String &from, const String &to)
+{
+#if defined(WINDOWS_VERSION)
+    // rename does not overwrite existing files on Windows; the old file
+    // must stay if the new one cannot take its place
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+void write_save_job(AsyncSaveJob *job)
+{
+    TraceScope trace("save", "write_savegame", "slot", job->Slot);
+    job->Success = write_savegame_image(job->TempPath, job->Image, job->DataOffset, job->Screenshot, job->Palette) &&
+        replace_file(job->TempPath, job->Path);
+    if (!job->Success)
+        unlink(job->TempPath);
+
+    delete job->Image;
+    job->Image = NULL;
+    delete job->Screenshot;
+    job->Screenshot = NULL;
+}
+
+void async_saver_entry()
+{
+    // The thread entry is called repeatedly until the thread is stopped
+    if (saver_quit)
+        return;
+    saver_wake.Wait();
+    if (saver_quit)
+        return;
+
+    MutexLock lock(saver_mutex);
+    AsyncSaveJob *job = saver_job;
+    saver_job = NULL;
+    lock.Release();
+    if (job == NULL)
+        return;
+
+    write_save_job(job);
+
+    lock.Acquire(saver_mutex);
+    job->Done = true;
+    job->Finished.Post();
+}
+
+void async_saver_thread_entry()
+{
+    static bool thread_named = false;
+    if (!thread_named)
+    {
+        Tracer::SetThreadName("game saver");
+        thread_named = true;
+    }
+    async_saver_entry();
+}
+
+bool start_async_saver()
+{
+    if (saver_state < 0)
+    {
+        saver_quit = false;
+        saver_state = saver_thread.CreateAndStart(async_saver_thread_entry, true) ? 1 : 0;
+        Out::FPrint(saver_state > 0 ? "Started game saving thread" :
+            "Failed to start game saving thread, games will be saved synchronously");
+    }
+    return saver_state > 0;
+}
+
+bool can_save_game_async()
+{
+    if (!usetup.async_save)
+        return false;
+    // Plugins write their data straight into the file
+    if (pl_any_want_hook(AGSE_SAVEGAME))
+        return false;
+    return start_async_saver();
+}
+
+void save_game_async(const String &path, int slotn, MemoryStream *image, size_t data_offset, Bitmap *screenshot)
+{
+    // The caller must have waited for the previous save
+    AsyncSaveJob *job = new AsyncSaveJob();
+    job->Path = path;
+    job->TempPath = String::FromFormat("%s""savegame.tmp", saveGameDirectory);
+    job->Slot = slotn;
+    job->Image = image;
+    job->DataOffset = data_offset;
+    job->Screenshot = screenshot;
+    memcpy(job->Palette, palette, sizeof(job->Palette));
+    job->Success = false;
+    job->Done = false;
+    pending_save = job;
+
+    MutexLock lock(saver_mutex);
+    saver_job = job;
+    lock.Release();
+    saver_wake.Post();
+}
+
+void wait_for_async_save()
+{
+    if (pending_save == NULL)
+        return;
+    MutexLock lock(saver_mutex);
+    if (!pending_save->Done)
+    {
+        lock.Release();
+        TraceScope trace("save", "wait_for_async_save");
+        pending_save->Finished.Wait();
+    }
+}
+
+void update_async_save()
+{
+    if (pending_save == NULL)
+        return;
+    MutexLock lock(saver_mutex);
+    if (!pending_save->Done)
+        return;
+    lock.Release();
+
+    AsyncSaveJob *job = pending_save;
+    pending_save = NULL;
+    if (!job->Success)
+        Out::FPrint("Failed to write saved game '%s'", job->Path.GetCStr());
+    on_game_saved(job->Slot, job->Success);
+    delete job;
+}
+
+void shutdown_async_save()
+{
+    wait_for_async_save();
+    if (pending_save != NULL)
+    {
+        if (!pending_save->Success)
+            Out::FPrint("Failed to write saved game '%s'", pending_save->Path.GetCStr());
+        delete pending_save;
+        pending_save = NULL;
+    }
+
+    if (saver_state > 0)
+    {
+        saver_quit = true;
+        saver_wake.Post();
+        saver_thread.Stop();
+    }
+    saver_state = 0;
+}
+
+#else // !AGS_HAS_ASYNC_SAVE
+
+bool can_save_game_async()
+{
+    return false;
+}
+
+void save_game_async(const Common::String &path, int slotn, Common::MemoryStream *image,
+                     size_t data_offset, Common::Bitmap *screenshot)
+{
+}
+
+void wait_for_async_save()
+{
+}
+
+void update_async_save()
+{
+}
+
+void shutdown_async_save()
+{
+}
+
+#endif // AGS_HAS_ASYNC_SAVE
@@ -0,0 +1,45 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Writing saved games in background.
+//
+// save_game puts the whole saved game into memory first, which is quick,
+// and the saving thread then compresses it and writes it to a temporary
+// file, which replaces the slot's file once complete. The script learns
+// of the result by the on_event call when the file is written. Anything
+// reading the saved games must wait for the pending save first.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__ASYNCSAVE_H
+#define __AGS_EE_AC__ASYNCSAVE_H
+
+#include "core/types.h"
+
+namespace AGS { namespace Common { class Bitmap; class MemoryStream; class String; } }
+using namespace AGS; // FIXME later
+
+// Tells whether the game may be saved in background
+bool can_save_game_async();
+// Starts writing the saved game image to the file on the saving thread;
+// takes ownership of the image and the screenshot
+void save_game_async(const Common::String &path, int slotn, Common::MemoryStream *image,
+                     size_t data_offset, Common::Bitmap *screenshot);
+// Waits until the saved game being written in background is complete
+void wait_for_async_save();
+// Tells the script about the completed save
+void update_async_save();
+// Completes the pending save and stops the saving thread
+void shutdown_async_save();
+
+#endif // __AGS_EE_AC__ASYNCSAVE_H
@@ -17,6 +17,7 @@
 #include "debug/debug_log.h"
 #include "ac/gamestate.h"
 #include "media/audio/audio.h"
+#include "media/audio/audiocommands.h"
 #include "media/audio/soundclip.h"
 #include "script/runtimescriptvalue.h"
 #include "ac/dynobj/cc_audioclip.h"
@@ -63,7 +64,7 @@ void AudioChannel_SetPanning(ScriptAudioChannel *channel, int newPanning)
     if ((channels[channel->id] != NULL) &&
         (channels[channel->id]->done == 0))
     {
-        channels[channel->id]->set_panning(((newPanning + 100) * 255) / 200);
+        audio_channel_set_panning(channel->id, ((newPanning + 100) * 255) / 200);
         channels[channel->id]->panningAsPercentage = newPanning;
     }
 }
@@ -86,7 +87,7 @@ int AudioChannel_GetPosition(ScriptAudioChannel *channel)
         if (play.fast_forward)
             return 999999999;
 
-        return channels[channel->id]->get_pos();
+        return audio_channel_get_pos(channel->id);
     }
     return 0;
 }
@@ -99,7 +100,7 @@ int AudioChannel_GetPositionMs(ScriptAudioChannel *channel)
         if (play.fast_forward)
             return 999999999;
 
-        return channels[channel->id]->get_pos_ms();
+        return audio_channel_get_pos_ms(channel->id);
     }
     return 0;
 }
@@ -132,7 +133,9 @@ int AudioChannel_SetVolume(ScriptAudioChannel *channel, int newVolume)
     if ((channels[channel->id] != NULL) &&
         (channels[channel->id]->done == 0))
     {
-        channels[channel->id]->set_volume_origin(newVolume);
+        channels[channel->id]->volAsPercentage = newVolume;
+        channels[channel->id]->originalVolAsPercentage = newVolume;
+        audio_channel_set_volume(channel->id, (newVolume * 255) / 100);
     }
     return 0;
 }
@@ -151,7 +154,7 @@ void AudioChannel_Seek(ScriptAudioChannel *channel, int newPosition)
     if ((channels[channel->id] != NULL) &&
         (channels[channel->id]->done == 0))
     {
-        channels[channel->id]->seek(newPosition);
+        audio_channel_seek(channel->id, newPosition);
     }
 }
 
@@ -171,7 +174,7 @@ void AudioChannel_SetRoomLocation(ScriptAudioChannel *channel, int xPos, int yPo
         else
         {
             channels[channel->id]->directionalVolModifier = 0;
-            channels[channel->id]->set_volume(channels[channel->id]->vol);
+            audio_channel_set_volume(channel->id, channels[channel->id]->vol);
         }
     }
 }
@@ -83,7 +83,7 @@ void Button_SetText(GUIButton *butt, const char *newtx) {
     if (strlen(newtx) > 49) quit("!SetButtonText: text too long, button has 50 chars max");
 
     if (strcmp(butt->text, newtx)) {
-        guis_need_update = 1;
+        butt->MarkChanged();
         strcpy(butt->text,newtx);
     }
 }
@@ -94,7 +94,7 @@ void Button_SetFont(GUIButton *butt, int newFont) {
 
     if (butt->font != newFont) {
         butt->font = newFont;
-        guis_need_update = 1;
+        butt->MarkChanged();
     }
 }
 
@@ -113,7 +113,7 @@ void Button_SetClipImage(GUIButton *butt, int newval) {
     if (newval)
         butt->flags |= GUIF_CLIP;
 
-    guis_need_update = 1;
+    butt->MarkChanged();
 }
 
 int Button_GetGraphic(GUIButton *butt) {
@@ -134,7 +134,7 @@ void Button_SetMouseOverGraphic(GUIButton *guil, int slotn) {
         guil->usepic = slotn;
     guil->overpic = slotn;
 
-    guis_need_update = 1;
+    guil->MarkChanged();
     FindAndRemoveButtonAnimation(guil->guin, guil->objn);
 }
 
@@ -152,7 +152,7 @@ void Button_SetNormalGraphic(GUIButton *guil, int slotn) {
     guil->wid = spritewidth[slotn];
     guil->hit = spriteheight[slotn];
 
-    guis_need_update = 1;
+    guil->MarkChanged();
     FindAndRemoveButtonAnimation(guil->guin, guil->objn);
 }
 
@@ -167,7 +167,7 @@ void Button_SetPushedGraphic(GUIButton *guil, int slotn) {
         guil->usepic = slotn;
     guil->pushedpic = slotn;
 
-    guis_need_update = 1;
+    guil->MarkChanged();
     FindAndRemoveButtonAnimation(guil->guin, guil->objn);
 }
 
@@ -178,7 +178,7 @@ int Button_GetTextColor(GUIButton *butt) {
 void Button_SetTextColor(GUIButton *butt, int newcol) {
     if (butt->textcol != newcol) {
         butt->textcol = newcol;
-        guis_need_update = 1;
+        butt->MarkChanged();
     }
 }
 
@@ -222,7 +222,7 @@ int UpdateAnimatingButton(int bu) {
     guibuts[animbuts[bu].buttonid].usepic = guibuts[animbuts[bu].buttonid].pic;
     guibuts[animbuts[bu].buttonid].pushedpic = 0;
     guibuts[animbuts[bu].buttonid].overpic = 0;
-    guis_need_update = 1;
+    guibuts[animbuts[bu].buttonid].MarkChanged();
 
     animbuts[bu].wait = animbuts[bu].speed + tview->loops[animbuts[bu].loop].frames[animbuts[bu].frame].speed;
     return 0;
@@ -19,6 +19,7 @@
 #include "ac/character.h"
 #include "ac/common.h"
 #include "ac/gamesetupstruct.h"
+#include "ac/roommask.h"
 #include "ac/roomstruct.h"
 #include "ac/view.h"
 #include "ac/display.h"
@@ -1758,7 +1759,7 @@ int doNextCharMoveStep (CharacterInfo *chi, int &char_index, CharacterExtras *ch
 
 int find_nearest_walkable_area_within(int *xx, int *yy, int range, int step)
 {
-    int ex, ey, nearest = 99999, thisis, nearx = 0, neary = 0;
+    int nearx = 0, neary = 0;
     int startx = 0, starty = 14;
     int roomWidthLowRes = convert_to_low_res(thisroom.width);
     int roomHeightLowRes = convert_to_low_res(thisroom.height);
@@ -1790,20 +1791,18 @@ int find_nearest_walkable_area_within(int *xx, int *yy, int range, int step)
         if (yheight > roomHeightLowRes) yheight = roomHeightLowRes;
     }
 
-    for (ex = startx; ex < xwidth; ex += step) {
-        for (ey = starty; ey < yheight; ey += step) {
-            // non-walkalbe, so don't go here
-            if (thisroom.walls->GetPixel(ex,ey) == 0) continue;
-            // off a screen edge, don't move them there
-            if ((ex <= leftEdge) || (ex >= rightEdge) ||
-                (ey <= topEdge) || (ey >= bottomEdge))
-                continue;
-            // otherwise, calculate distance from target
-            thisis=(int) ::sqrt((double)((ex - xLowRes) * (ex - xLowRes) + (ey - yLowRes) * (ey - yLowRes)));
-            if (thisis<nearest) { nearest=thisis; nearx=ex; neary=ey; }
-        }
-    }
-    if (nearest < 90000) 
+    // off a screen edge, don't move them there; skip the points before the
+    // edges, keeping the same step from the start
+    if (startx <= leftEdge)
+        startx += ((leftEdge - startx) / step + 1) * step;
+    if (starty <= topEdge)
+        starty += ((topEdge - starty) / step + 1) * step;
+    if (xwidth > rightEdge)
+        xwidth = rightEdge;
+    if (yheight > bottomEdge)
+        yheight = bottomEdge;
+
+    if (find_nearest_mask_point(thisroom.walls, startx, starty, xwidth, yheight, step, -1, xLowRes, yLowRes, nearx, neary))
     {
         xx[0] = convert_back_to_high_res(nearx);
         yy[0] = convert_back_to_high_res(neary);
@@ -1816,7 +1815,7 @@ int find_nearest_walkable_area_within(int *xx, int *yy, int range, int step)
 void find_nearest_walkable_area (int *xx, int *yy) {
 
 
-    int pixValue = thisroom.walls->GetPixel(convert_to_low_res(xx[0]), convert_to_low_res(yy[0]));
+    int pixValue = get_mask_pixel(thisroom.walls, convert_to_low_res(xx[0]), convert_to_low_res(yy[0]));
     // only fix this code if the game was built with 2.61 or above
     if (pixValue == 0 || (loaded_game_file_version >= kGameVersion_261 && pixValue < 1))
     {
@@ -2063,12 +2062,19 @@ int is_pos_on_character(int xx,int yy) {
         int xxx = chin->x - divide_down_coordinate(usewid) / 2;
         int yyy = chin->get_effective_y() - divide_down_coordinate(usehit);
 
+        // Test the bounding box before getting the image, which may have to
+        // be loaded into the sprite cache
+        const int spww = divide_down_coordinate(usewid);
+        const int sphh = divide_down_coordinate(usehit);
+        if ((spww != 0) && (sphh != 0) &&
+            (isposinbox(xx, yy, xxx, yyy, xxx + spww, yyy + sphh) == FALSE))
+            continue;
+
         int mirrored = views[chin->view].loops[chin->loop].frames[chin->frame].flags & VFLG_FLIPSPRITE;
         Bitmap *theImage = GetCharacterImage(cc, &mirrored);
 
         if (is_pos_in_sprite(xx,yy,xxx,yyy, theImage,
-            divide_down_coordinate(usewid),
-            divide_down_coordinate(usehit), mirrored) == FALSE)
+            spww, sphh, mirrored) == FALSE)
             continue;
 
         int use_base = chin->get_baseline();
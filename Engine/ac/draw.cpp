@@ -12,6 +12,7 @@
 //
 //=============================================================================
 
+#include <vector>
 #include "aastr.h"
 #include "ac/common.h"
 #include "util/compress.h"
@@ -46,6 +47,7 @@
 #include "ac/dynobj/scriptsystem.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
+#include "debug/frametimer.h"
 #include "font/fonts.h"
 #include "gui/guimain.h"
 #include "media/audio/audio.h"
@@ -56,9 +58,11 @@
 #include "gfx/ddb.h"
 #include "gfx/gfx_util.h"
 #include "gfx/graphicsdriver.h"
+#include "util/math.h"
 
 using AGS::Common::Bitmap;
 namespace BitmapHelper = AGS::Common::BitmapHelper;
+namespace Math = AGS::Common::Math;
 
 #if defined(ANDROID_VERSION)
 #include <sys/stat.h>
@@ -82,10 +86,9 @@ extern AGSPlatformDriver *platform;
 extern roomstruct thisroom;
 extern char noWalkBehindsAtAll;
 extern unsigned int loopcounter;
-extern char *walkBehindExists;  // whether a WB area is in this column
-extern int *walkBehindStartY, *walkBehindEndY;
 extern int walkBehindLeft[MAX_OBJ], walkBehindTop[MAX_OBJ];
 extern int walkBehindRight[MAX_OBJ], walkBehindBottom[MAX_OBJ];
+extern unsigned char *walkBehindMask[MAX_OBJ];
 extern IDriverDependantBitmap *walkBehindBitmap[MAX_OBJ];
 extern int walkBehindsCachedForBgNum;
 extern WalkBehindMethodEnum walkBehindMethod;
@@ -751,6 +754,7 @@ void render_to_screen(Bitmap *toRender, int atx, int aty) {
     {
         try
         {
+            FramePhaseScope phase(kFramePhase_DriverRender);
             gfxDriver->Render((GlobalFlipType)play.screen_flipped);
 
 #if defined(ANDROID_VERSION)
@@ -891,6 +895,81 @@ void invalidate_cached_walkbehinds()
     memset(&actspswbcache[0], 0, sizeof(CachedActSpsData) * actSpsCount);
 }
 
+// Walk-behind line helpers: each processes one sprite scanline against a
+// row of an area's coverage mask. The pixel choice is made with a bitwise
+// select instead of a branch, so that compilers may vectorize the loops.
+template <typename T>
+inline bool wb_hide_line(T *dst, const unsigned char *mask, int count, T maskcol)
+{
+    unsigned char hit = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const T m = (T)(signed char)mask[i];
+        dst[i] = (dst[i] & ~m) | (maskcol & m);
+        hit |= mask[i];
+    }
+    return hit != 0;
+}
+
+template <typename T>
+inline bool wb_copy_line(T *dst, const T *bg, const T *check, const unsigned char *mask, int count, T maskcol)
+{
+    unsigned char hit = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const unsigned char sel = mask[i] & (unsigned char)-(check[i] != maskcol);
+        const T m = (T)(signed char)sel;
+        dst[i] = (dst[i] & ~m) | (bg[i] & m);
+        hit |= sel;
+    }
+    return hit != 0;
+}
+
+// Zoomed variant: sprite columns are mapped to the source ones through
+// a precalculated lookup table
+template <typename T>
+inline bool wb_copy_line_zoomed(T *dst, const T *bg, const T *check, const int *checkx, const unsigned char *mask, int count, T maskcol)
+{
+    unsigned char hit = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const unsigned char sel = mask[i] & (unsigned char)-(check[checkx[i]] != maskcol);
+        const T m = (T)(signed char)sel;
+        dst[i] = (dst[i] & ~m) | (bg[i] & m);
+        hit |= sel;
+    }
+    return hit != 0;
+}
+
+// 24-bit pixels have no matching integer type, handle them bytewise
+bool wb_hide_line24(unsigned char *dst, const unsigned char *mask, int count, int maskcol)
+{
+    bool hit = false;
+    for (int i = 0; i < count; ++i)
+    {
+        if (mask[i])
+        {
+            memcpy(&dst[i * 3], &maskcol, 3);
+            hit = true;
+        }
+    }
+    return hit;
+}
+
+bool wb_copy_line24(unsigned char *dst, const unsigned char *bg, const unsigned char *check, const int *checkx, const unsigned char *mask, int count, int maskcol)
+{
+    bool hit = false;
+    for (int i = 0; i < count; ++i)
+    {
+        if (mask[i] && memcmp(&check[checkx[i] * 3], &maskcol, 3) != 0)
+        {
+            memcpy(&dst[i * 3], &bg[i * 3], 3);
+            hit = true;
+        }
+    }
+    return hit;
+}
+
 // sort_out_walk_behinds: modifies the supplied sprite by overwriting parts
 // of it with transparent pixels where there are walk-behind areas
 // Returns whether any pixels were updated
@@ -902,111 +981,102 @@ int sort_out_walk_behinds(Bitmap *sprit,int xx,int yy,int basel, Bitmap *copyPix
         (!sprit->IsMemoryBitmap()))
         quit("!sort_out_walk_behinds: wb bitmap not linear");
 
-    int rr,tmm, toheight;//,tcol;
     // precalculate this to try and shave some time off
-    int maskcol = sprit->GetMaskColor();
-    int spcoldep = sprit->GetColorDepth();
-    int screenhit = thisroom.object->GetHeight();
-    short *shptr, *shptr2;
-    int *loptr, *loptr2;
+    const int maskcol = sprit->GetMaskColor();
+    const int spcoldep = sprit->GetColorDepth();
+    const int spwidth = sprit->GetWidth();
+    const int spheight = sprit->GetHeight();
     int pixelsChanged = 0;
-    int ee = 0;
-    if (xx < 0)
-        ee = 0 - xx;
 
     if ((checkPixelsFrom != NULL) && (checkPixelsFrom->GetColorDepth() != spcoldep))
         quit("sprite colour depth does not match background colour depth");
+    if (spcoldep > 32)
+        quit("!Sprite colour depth >32 ??");
+
+    // Map the sprite coordinates to the unscaled source sprite once,
+    // rather than dividing for every pixel
+    static std::vector<int> checkx;
+    static std::vector<int> checky;
+    const bool zoomed = (copyPixelsFrom != NULL) && (zoom != 100);
+    if (copyPixelsFrom != NULL)
+    {
+        if ((int)checkx.size() < spwidth)
+            checkx.resize(spwidth);
+        if ((int)checky.size() < spheight)
+            checky.resize(spheight);
+        for (int i = 0; i < spwidth; ++i)
+            checkx[i] = (i * 100) / zoom;
+        for (int i = 0; i < spheight; ++i)
+            checky[i] = (i * 100) / zoom;
+    }
+
+    // Walk-behind areas never overlap, so each may be applied separately,
+    // restricted to where its bounding box intersects the sprite
+    for (int tmm = 1; tmm < MAX_OBJ; tmm++)
+    {
+        if (walkBehindMask[tmm] == NULL)
+            continue;
+        if (croom->walkbehind_base[tmm] <= basel)
+            continue;
 
-    for ( ; ee < sprit->GetWidth(); ee++) {
-        if (ee + xx >= thisroom.object->GetWidth())
-            break;
-
-        if ((!walkBehindExists[ee+xx]) ||
-            (walkBehindEndY[ee+xx] <= yy) ||
-            (walkBehindStartY[ee+xx] > yy+sprit->GetHeight()))
+        const int left = Math::Max(xx, walkBehindLeft[tmm]);
+        const int right = Math::Min(xx + spwidth - 1, walkBehindRight[tmm]);
+        const int top = Math::Max(yy, walkBehindTop[tmm]);
+        const int bottom = Math::Min(yy + spheight - 1, walkBehindBottom[tmm]);
+        if (left > right || top > bottom)
             continue;
 
-        toheight = sprit->GetHeight();
+        const int count = (right - left) + 1;
+        const int maskWidth = (walkBehindRight[tmm] - walkBehindLeft[tmm]) + 1;
+        const int ee = left - xx;
+        const int bpp = (spcoldep + 7) / 8;
 
-        if (walkBehindStartY[ee+xx] < yy)
-            rr = 0;
-        else
-            rr = (walkBehindStartY[ee+xx] - yy);
-
-        // Since we will use _getpixel, ensure we only check within the screen
-        if (rr + yy < 0)
-            rr = 0 - yy;
-        if (toheight + yy > screenhit)
-            toheight = screenhit - yy;
-        if (toheight + yy > walkBehindEndY[ee+xx])
-            toheight = walkBehindEndY[ee+xx] - yy;
-        if (rr < 0)
-            rr = 0;
-
-        for ( ; rr < toheight;rr++) {
-
-            // we're ok with _getpixel because we've checked the screen edges
-            //tmm = _getpixel(thisroom.object,ee+xx,rr+yy);
-            // actually, _getpixel is well inefficient, do it ourselves
-            // since we know it's 8-bit bitmap
-            tmm = thisroom.object->GetScanLine(rr+yy)[ee+xx];
-            if (tmm<1) continue;
-            if (croom->walkbehind_base[tmm] <= basel) continue;
+        for (int y = top; y <= bottom; y++)
+        {
+            const int rr = y - yy;
+            const unsigned char *mask = walkBehindMask[tmm] + (y - walkBehindTop[tmm]) * maskWidth + (left - walkBehindLeft[tmm]);
+            unsigned char *dst = sprit->GetScanLineForWriting(rr) + ee * bpp;
+            bool hit;
 
             if (copyPixelsFrom != NULL)
             {
-                if (spcoldep <= 8)
+                const unsigned char *bg = copyPixelsFrom->GetScanLine(y) + left * bpp;
+                const unsigned char *check = checkPixelsFrom->GetScanLine(checky[rr]);
+                if (spcoldep == 24)
+                    hit = wb_copy_line24(dst, bg, check, &checkx[ee], mask, count, maskcol);
+                else if (zoomed)
                 {
-                    if (checkPixelsFrom->GetScanLine((rr * 100) / zoom)[(ee * 100) / zoom] != maskcol) {
-                        sprit->GetScanLineForWriting(rr)[ee] = copyPixelsFrom->GetScanLine(rr + yy)[ee + xx];
-                        pixelsChanged = 1;
-                    }
-                }
-                else if (spcoldep <= 16) {
-                    shptr = (short*)&sprit->GetScanLine(rr)[0];
-                    shptr2 = (short*)&checkPixelsFrom->GetScanLine((rr * 100) / zoom)[0];
-                    if (shptr2[(ee * 100) / zoom] != maskcol) {
-                        shptr[ee] = ((short*)(&copyPixelsFrom->GetScanLine(rr + yy)[0]))[ee + xx];
-                        pixelsChanged = 1;
-                    }
+                    if (spcoldep <= 8)
+                        hit = wb_copy_line_zoomed<uint8_t>(dst, bg, check, &checkx[ee], mask, count, maskcol);
+                    else if (spcoldep <= 16)
+                        hit = wb_copy_line_zoomed<uint16_t>((uint16_t*)dst, (const uint16_t*)bg, (const uint16_t*)check, &checkx[ee], mask, count, maskcol);
+                    else
+                        hit = wb_copy_line_zoomed<uint32_t>((uint32_t*)dst, (const uint32_t*)bg, (const uint32_t*)check, &checkx[ee], mask, count, maskcol);
                 }
-                else if (spcoldep == 24) {
-                    char *chptr = (char*)&sprit->GetScanLine(rr)[0];
-                    char *chptr2 = (char*)&checkPixelsFrom->GetScanLine((rr * 100) / zoom)[0];
-                    if (memcmp(&chptr2[((ee * 100) / zoom) * 3], &maskcol, 3) != 0) {
-                        memcpy(&chptr[ee * 3], &copyPixelsFrom->GetScanLine(rr + yy)[(ee + xx) * 3], 3);
-                        pixelsChanged = 1;
-                    }
-                }
-                else if (spcoldep <= 32) {
-                    loptr = (int*)&sprit->GetScanLine(rr)[0];
-                    loptr2 = (int*)&checkPixelsFrom->GetScanLine((rr * 100) / zoom)[0];
-                    if (loptr2[(ee * 100) / zoom] != maskcol) {
-                        loptr[ee] = ((int*)(&copyPixelsFrom->GetScanLine(rr + yy)[0]))[ee + xx];
-                        pixelsChanged = 1;
-                    }
+                else
+                {
+                    if (spcoldep <= 8)
+                        hit = wb_copy_line<uint8_t>(dst, bg, check + ee, mask, count, maskcol);
+                    else if (spcoldep <= 16)
+                        hit = wb_copy_line<uint16_t>((uint16_t*)dst, (const uint16_t*)bg, (const uint16_t*)check + ee, mask, count, maskcol);
+                    else
+                        hit = wb_copy_line<uint32_t>((uint32_t*)dst, (const uint32_t*)bg, (const uint32_t*)check + ee, mask, count, maskcol);
                 }
             }
             else
             {
-                pixelsChanged = 1;
                 if (spcoldep <= 8)
-                    sprit->GetScanLineForWriting(rr)[ee] = maskcol;
-                else if (spcoldep <= 16) {
-                    shptr = (short*)&sprit->GetScanLine(rr)[0];
-                    shptr[ee] = maskcol;
-                }
-                else if (spcoldep == 24) {
-                    char *chptr = (char*)&sprit->GetScanLine(rr)[0];
-                    memcpy(&chptr[ee * 3], &maskcol, 3);
-                }
-                else if (spcoldep <= 32) {
-                    loptr = (int*)&sprit->GetScanLine(rr)[0];
-                    loptr[ee] = maskcol;
-                }
+                    hit = wb_hide_line<uint8_t>(dst, mask, count, maskcol);
+                else if (spcoldep <= 16)
+                    hit = wb_hide_line<uint16_t>((uint16_t*)dst, mask, count, maskcol);
+                else if (spcoldep == 24)
+                    hit = wb_hide_line24(dst, mask, count, maskcol);
                 else
-                    quit("!Sprite colour depth >32 ??");
+                    hit = wb_hide_line<uint32_t>((uint32_t*)dst, mask, count, maskcol);
             }
+
+            if (hit)
+                pixelsChanged = 1;
         }
     }
     return pixelsChanged;
@@ -1025,6 +1095,7 @@ void sort_out_char_sprite_walk_behind(int actspsIndex, int xx, int yy, int basel
         actspswb[actspsIndex] = recycle_bitmap(actspswb[actspsIndex], thisroom.ebscene[play.bg_frame]->GetColorDepth(), width, height, true);
         Bitmap *wbSprite = actspswb[actspsIndex];
 
+        FramePhaseScope phase(kFramePhase_WalkBehinds);
         actspswbcache[actspsIndex].isWalkBehindHere = sort_out_walk_behinds(wbSprite, xx, yy, basel, thisroom.ebscene[play.bg_frame], actsps[actspsIndex], zoom);
         actspswbcache[actspsIndex].xWas = xx;
         actspswbcache[actspsIndex].yWas = yy;
@@ -1692,6 +1763,7 @@ void prepare_objects_for_drawing() {
         }
         else if ((!actspsIntact) && (walkBehindMethod == DrawOverCharSprite))
         {
+            FramePhaseScope phase(kFramePhase_WalkBehinds);
             sort_out_walk_behinds(actsps[useindx],atxp+offsetx,atyp+offsety,usebasel);
         }
 
@@ -1999,6 +2071,7 @@ void prepare_characters_for_drawing() {
         }
         else if (walkBehindMethod == DrawOverCharSprite)
         {
+            FramePhaseScope phase(kFramePhase_WalkBehinds);
             sort_out_walk_behinds(actsps[useindx], bgX, bgY, usebasel);
         }
 
@@ -2116,9 +2189,12 @@ void draw_screen_background(Bitmap *ds) {
 
     if ((debug_flags & DBG_NOOBJECTS)==0) {
 
-        prepare_objects_for_drawing();
+        {
+            FramePhaseScope phase(kFramePhase_Sprites);
+            prepare_objects_for_drawing();
 
-        prepare_characters_for_drawing ();
+            prepare_characters_for_drawing ();
+        }
 
         if ((debug_flags & DBG_NODRAWSPRITES)==0) {
             our_eip=34;
@@ -2166,6 +2242,42 @@ void draw_fps()
     draw_and_invalidate_text(ds, get_fixed_pixel_size(250), yp, FONT_SPEECH, text_color, tbuffer);
 }
 
+// Displays percentiles of the frame phase timings, in milliseconds
+void draw_frame_timings()
+{
+    static IDriverDependantBitmap* ddb = NULL;
+    static Bitmap *timingsDisplay = NULL;
+
+    const int lineHeight = wgetfontheight(FONT_NORMAL) + get_fixed_pixel_size(1);
+    if (timingsDisplay == NULL)
+    {
+        timingsDisplay = BitmapHelper::CreateBitmap(get_fixed_pixel_size(160), lineHeight * (kNumFramePhases + 1) + get_fixed_pixel_size(2), final_col_dep);
+        timingsDisplay = gfxDriver->ConvertBitmapToSupportedColourDepth(timingsDisplay);
+    }
+    timingsDisplay->ClearTransparent();
+    color_t text_color = timingsDisplay->GetCompatibleColor(14);
+    char tbuffer[60];
+    wouttext_outline(timingsDisplay, 1, 1, FONT_NORMAL, text_color, "ms: p50 p99 max");
+    for (int i = 0; i < kNumFramePhases; ++i)
+    {
+        const FramePhase phase = (FramePhase)i;
+        const int p50 = FrameTimer::GetPercentile(phase, 50);
+        const int p99 = FrameTimer::GetPercentile(phase, 99);
+        const int max = FrameTimer::GetMax(phase);
+        sprintf(tbuffer, "%s: %d.%d %d.%d %d.%d", FrameTimer::GetPhaseName(phase),
+            p50 / 1000, (p50 % 1000) / 100, p99 / 1000, (p99 % 1000) / 100, max / 1000, (max % 1000) / 100);
+        wouttext_outline(timingsDisplay, 1, 1 + lineHeight * (i + 1), FONT_NORMAL, text_color, tbuffer);
+    }
+
+    if (ddb == NULL)
+        ddb = gfxDriver->CreateDDBFromBitmap(timingsDisplay, false);
+    else
+        gfxDriver->UpdateDDBFromBitmap(ddb, timingsDisplay, false);
+
+    gfxDriver->DrawSprite(1, 1, ddb);
+    invalidate_sprite(1, 1, ddb);
+}
+
 // draw_screen_overlay: draws any stuff currently on top of the background,
 // like a message box or popup interface
 void draw_screen_overlay() {
@@ -2204,11 +2316,17 @@ void draw_screen_overlay() {
         guis[aa].poll();
         }*/
         our_eip = 37;
-        if (guis_need_update) {
+        {
+            FramePhaseScope phase(kFramePhase_GUI);
             //Bitmap *abufwas = ds;
+            // guis_need_update forces all the GUIs to redraw, otherwise only
+            // those which were marked as changed are redrawn and re-uploaded
+            const bool redraw_all = guis_need_update != 0;
             guis_need_update = 0;
             for (aa=0;aa<game.numgui;aa++) {
                 if (guis[aa].on<1) continue;
+                if (!redraw_all && guibgbmp[aa] != NULL && !guis[aa].has_changed()) continue;
+                guis[aa].clear_changed();
 
                 if (guibg[aa] == NULL)
                     recreate_guibg_image(&guis[aa]);
@@ -2329,6 +2447,10 @@ void draw_misc_info()
     {
         draw_fps();
     }
+    if (FrameTimer::IsEnabled())
+    {
+        draw_frame_timings();
+    }
 
     Bitmap *ds = GetVirtualScreen();
 
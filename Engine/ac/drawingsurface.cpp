@@ -92,8 +92,7 @@ void DrawingSurface_Release(ScriptDrawingSurface* sds)
                 if ((guis[tt].bgpic == sds->dynamicSpriteNumber) &&
                     (guis[tt].on == 1))
                 {
-                    guis_need_update = 1;
-                    break;
+                    guis[tt].mark_changed();
                 }
             }
         }
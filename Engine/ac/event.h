@@ -31,6 +31,8 @@
 #define GE_ADD_INV       7
 #define GE_LOSE_INV      8
 #define GE_RESTORE_GAME  9
+#define GE_SAVE_GAME     10
+#define GE_SAVE_GAME_FAILED 11
 
 #define MAXEVENTS 15
 
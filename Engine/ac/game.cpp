@@ -14,6 +14,7 @@
 
 #include "ac/common.h"
 #include "ac/view.h"
+#include "ac/asyncsave.h"
 #include "ac/audiochannel.h"
 #include "ac/character.h"
 #include "ac/charactercache.h"
@@ -26,6 +27,7 @@
 #include "ac/game.h"
 #include "ac/gamesetup.h"
 #include "ac/gamesetupstruct.h"
+#include "ac/gamesnapshot.h"
 #include "ac/gamestate.h"
 #include "ac/global_audio.h"
 #include "ac/global_character.h"
@@ -49,6 +51,7 @@
 #include "ac/roomstatus.h"
 #include "ac/roomstruct.h"
 #include "ac/runtime_defines.h"
+#include "ac/savegameindex.h"
 #include "ac/screenoverlay.h"
 #include "ac/spritecache.h"
 #include "ac/string.h"
@@ -59,8 +62,10 @@
 #include "ac/dynobj/all_scriptclasses.h"
 #include "debug/debug_log.h"
 #include "debug/out.h"
+#include "debug/tracer.h"
 #include "device/mousew32.h"
 #include "font/fonts.h"
+#include "font/textlayoutcache.h"
 #include "gfx/ali3d.h"
 #include "gui/animatingguibutton.h"
 #include "gfx/graphicsdriver.h"
@@ -75,8 +80,10 @@
 #include "script/script.h"
 #include "script/script_runtime.h"
 #include "util/alignedstream.h"
+#include "util/compressedstream.h"
 #include "util/directory.h"
 #include "util/filestream.h"
+#include "util/memorystream.h"
 #include "util/string_utils.h"
 
 using namespace AGS::Common;
@@ -277,6 +284,7 @@ void Game_SetAudioTypeVolume(int audioType, int volume, int changeType)
             ScriptAudioClip *clip = AudioChannel_GetPlayingClip(&scrAudioChannel[aa]);
             if ((clip != NULL) && (clip->type == audioType))
             {
+                AGS::Engine::MutexLock _lock(_audio_poll_mutex);
                 channels[aa]->set_volume_origin(volume);
             }
         }
@@ -674,6 +682,7 @@ void unload_game_file() {
 
     for (ee=0;ee<game.numfonts;ee++)
         wfreefont(ee);
+    invalidate_text_layout_cache();
 
     free_do_once_tokens();
     free(play.gui_draw_order);
@@ -960,12 +969,16 @@ int Game_ChangeTranslation(const char *newFilename)
 // Saved game version history
 //
 // 8      original format (3.2.1)
+// 9      everything following the format version is compressed in blocks
+// 10     room states are written as the difference from a blank room state
 //-----------------------------------------------------------------------------
 enum SavedGameVersion
 {
     kSvgVersion_Undefined = 0,
     kSvgVersion_321       = 8,
-    kSvgVersion_Current   = kSvgVersion_321,
+    kSvgVersion_Compressed = 9,
+    kSvgVersion_RoomDelta = 10,
+    kSvgVersion_Current   = kSvgVersion_RoomDelta,
     kSvgVersion_LowestSupported = kSvgVersion_321
 };
 
@@ -1067,15 +1080,13 @@ Bitmap *read_serialized_bitmap(Stream *in) {
     return thispic;
 }
 
-long write_screen_shot_for_vista(Stream *out, Bitmap *screenshot)
+long write_screen_shot_for_vista(Stream *out, Bitmap *screenshot, const color *pal)
 {
     long fileSize = 0;
     char tempFileName[MAX_PATH];
     sprintf(tempFileName, "%s""_tmpscht.bmp", saveGameDirectory);
 
-	screenshot->SaveToFile(tempFileName, palette);
-
-    update_polled_stuff_if_runtime();
+	screenshot->SaveToFile(tempFileName, pal);
 
     if (exists(tempFileName))
     {
@@ -1167,6 +1178,84 @@ void WriteRoomStatus_Aligned(RoomStatus *roomstat, Stream *out)
     roomstat->WriteToFile_v321(&align_s);
 }
 
+// Runs of changed bytes closer to each other than this are joined,
+// as each run costs that much in the file
+const size_t DeltaRunGap = 2 * sizeof(int32_t);
+
+// Writes the data as the runs of bytes that differ from the base data;
+// if base is NULL, the data is compared against zeroes
+void write_data_delta(const uint8_t *data, const uint8_t *base, size_t size, Stream *out)
+{
+    size_t last_end = 0;
+    size_t pos = 0;
+    while (pos < size)
+    {
+        if (data[pos] == (base ? base[pos] : 0))
+        {
+            pos++;
+            continue;
+        }
+        size_t start = pos;
+        size_t end = pos + 1;
+        for (pos = end; pos < size && pos - end < DeltaRunGap; pos++)
+        {
+            if (data[pos] != (base ? base[pos] : 0))
+                end = pos + 1;
+        }
+        out->WriteInt32(start - last_end);
+        out->WriteInt32(end - start);
+        out->Write(data + start, end - start);
+        last_end = end;
+        pos = end;
+    }
+    // empty run ends the list
+    out->WriteInt32(0);
+    out->WriteInt32(0);
+}
+
+// Reads the runs written by write_data_delta over the buffer that holds
+// the base data
+void read_data_delta(uint8_t *data, size_t size, Stream *in)
+{
+    size_t pos = 0;
+    for (;;)
+    {
+        size_t skip = (uint32_t)in->ReadInt32();
+        size_t length = (uint32_t)in->ReadInt32();
+        if (length == 0)
+            break;
+        if (skip > size - pos || length > size - pos - skip)
+            quit("!Restore game error: room state data is corrupt");
+        pos += skip;
+        in->Read(data + pos, length);
+        pos += length;
+    }
+}
+
+// Writes the status of a room the player has not been in yet, the room
+// states are saved as the difference from; it must stay the same, for the
+// saved games made before could not be restored otherwise
+void write_blank_room_status(Stream *out)
+{
+    RoomStatus *blank = new RoomStatus;
+    blank->beenhere = 1;
+    memset(&blank->obj[0], 0, sizeof(blank->obj));
+    memset(&blank->flagstates[0], 0, sizeof(blank->flagstates));
+    for (int i = 0; i < MAX_HOTSPOTS; ++i)
+        memset(&blank->intrHotspot[i].eventTypes[0], 0, sizeof(blank->intrHotspot[i].eventTypes));
+    for (int i = 0; i < MAX_INIT_SPR; ++i)
+        memset(&blank->intrObject[i].eventTypes[0], 0, sizeof(blank->intrObject[i].eventTypes));
+    for (int i = 0; i < MAX_REGIONS; ++i)
+        memset(&blank->intrRegion[i].eventTypes[0], 0, sizeof(blank->intrRegion[i].eventTypes));
+    memset(&blank->intrRoom.eventTypes[0], 0, sizeof(blank->intrRoom.eventTypes));
+    memset(&blank->hotspot_enabled[0], 1, MAX_HOTSPOTS);
+    memset(&blank->region_enabled[0], 1, MAX_REGIONS);
+    memset(&blank->walkbehind_base[0], 0, sizeof(blank->walkbehind_base));
+    memset(&blank->interactionVariableValues[0], 0, sizeof(blank->interactionVariableValues));
+    WriteRoomStatus_Aligned(blank, out);
+    delete blank;
+}
+
 void save_game_room_state(Stream *out)
 {
     out->WriteInt32(displayed_room);
@@ -1180,7 +1269,12 @@ void save_game_room_state(Stream *out)
             croom->interactionVariableValues[ff] = thisroom.localvars[ff].value;
     }
 
-    // write the room state for all the rooms the player has been in
+    // write the room state for all the rooms the player has been in;
+    // most of the room status is what it was before the player entered
+    // the room, so only the changes are written
+    MemoryStream blank_image;
+    MemoryStream room_image;
+    write_blank_room_status(&blank_image);
     RoomStatus* roomstat;
     for (int bb = 0; bb < MAX_ROOMS; bb++) {
         if (isRoomStatusValid(bb))
@@ -1188,9 +1282,11 @@ void save_game_room_state(Stream *out)
             roomstat = getRoomStatus(bb);
             if (roomstat->beenhere) {
                 out->WriteInt8 (1);
-                WriteRoomStatus_Aligned(roomstat, out);
+                room_image.Clear();
+                WriteRoomStatus_Aligned(roomstat, &room_image);
+                write_data_delta(room_image.GetData(), blank_image.GetData(), room_image.GetLength(), out);
                 if (roomstat->tsdatasize>0)
-                    out->Write(&roomstat->tsdata[0], roomstat->tsdatasize);
+                    write_data_delta((const uint8_t*)roomstat->tsdata, NULL, roomstat->tsdatasize, out);
             }
             else
                 out->WriteInt8(0);
@@ -1409,17 +1505,24 @@ void WriteGameState_Aligned(Stream *out)
 
 #define MAGICNUMBER 0xbeefcafe
 // Write the save game position to the file
-void save_game_data (Stream *out, Bitmap *screenshot) {
+void save_game_data (Stream *base_out, Bitmap *screenshot, bool compress) {
 
     platform->RunPluginHooks(AGSE_PRESAVEGAME, 0);
-    out->WriteInt32(kSvgVersion_Current);
+    base_out->WriteInt32(kSvgVersion_Current);
+
+    // The rest is compressed; the larger sections end their blocks, so that
+    // the restore may decompress a section at a time as it parses them
+    CompressedStream comp_out(base_out, Common::kFile_Write, Common::kReleaseAfterUse, compress);
+    Stream *out = &comp_out;
 
     save_game_screenshot(out, screenshot);
     save_game_header(out);
     save_game_head_dynamic_values(out);
     save_game_spriteset(out);
     save_game_scripts(out);
+    out->Flush();
     save_game_room_state(out);
+    out->Flush();
 
     update_polled_stuff_if_runtime();
 
@@ -1442,6 +1545,7 @@ void save_game_data (Stream *out, Bitmap *screenshot) {
     game.WriteForSaveGame_v321(out);
 
     WriteCharacterExtras_Aligned(out);
+    out->Flush();
     save_game_palette(out);
     save_game_dialogs(out);
     save_game_more_dynamic_values(out);
@@ -1450,14 +1554,17 @@ void save_game_data (Stream *out, Bitmap *screenshot) {
     save_game_thisroom(out);
     save_game_ambientsounds(out);
     save_game_overlays(out);
+    out->Flush();
 
     update_polled_stuff_if_runtime();
 
     save_game_dynamic_surfaces(out);
+    out->Flush();
 
     update_polled_stuff_if_runtime();
 
     save_game_displayed_room_status(out);
+    out->Flush();
     save_game_globalvars(out);
     save_game_views(out);
 
@@ -1466,7 +1573,11 @@ void save_game_data (Stream *out, Bitmap *screenshot) {
     save_game_audioclips_and_crossfade(out);
 
     // [IKM] Plugins expect FILE pointer! // TODO something with this later...
-    platform->RunPluginHooks(AGSE_SAVEGAME, (long)((Common::FileStream*)out)->GetHandle());
+    // Plugin data is written uncompressed between the blocks; the game is
+    // only saved into memory if no plugin wants to write there
+    out->Flush();
+    if (pl_any_want_hook(AGSE_SAVEGAME))
+        platform->RunPluginHooks(AGSE_SAVEGAME, (long)((Common::FileStream*)base_out)->GetHandle());
     out->WriteInt32 (MAGICNUMBER);  // to verify the plugins
 
     // save the room music volume
@@ -1537,12 +1648,29 @@ void save_game(int slotn, const char*descript) {
     }
 
     VALIDATE_STRING(descript);
+    TraceScope trace("save", "save_game", "slot", slotn);
     String nametouse;
     nametouse = get_save_game_path(slotn);
 
-    Stream *out = Common::File::CreateFile(nametouse);
-    if (out == NULL)
-        quit("save_game: unable to open savegame file for writing");
+    // The previous save may still be written in background
+    wait_for_async_save();
+    update_async_save();
+    forget_savegame_info(nametouse);
+
+    // When saving in background, the game is first saved into memory and
+    // the file is written by the saving thread
+    const bool save_async = can_save_game_async();
+    Stream *out;
+    if (save_async)
+    {
+        out = new MemoryStream();
+    }
+    else
+    {
+        out = Common::File::CreateFile(nametouse);
+        if (out == NULL)
+            quit("save_game: unable to open savegame file for writing");
+    }
 
     // Initialize and write Vista header
     RICH_GAME_MEDIA_HEADER vistaHeader;
@@ -1579,16 +1707,24 @@ void save_game(int slotn, const char*descript) {
 
     update_polled_stuff_if_runtime();
 
-    // Actual dynamic game data is saved here
-    save_game_data(out, screenShot);
+    // Actual dynamic game data is saved here; compressing it is left to
+    // the saving thread
+    size_t data_offset = out->GetPosition() + sizeof(int32_t);
+    save_game_data(out, screenShot, !save_async);
 
     // End writing to the file here
     //===================================================================
 
+    if (save_async)
+    {
+        save_game_async(nametouse, slotn, (MemoryStream*)out, data_offset, screenShot);
+        return;
+    }
+
     if (screenShot != NULL)
     {
         int screenShotOffset = out->GetPosition() - sizeof(RICH_GAME_MEDIA_HEADER);
-        int screenShotSize = write_screen_shot_for_vista(out, screenShot);
+        int screenShotSize = write_screen_shot_for_vista(out, screenShot, palette);
         delete out;
 
         update_polled_stuff_if_runtime();
@@ -1606,6 +1742,42 @@ void save_game(int slotn, const char*descript) {
     delete out;
 }
 
+bool write_savegame_image(const String &path, MemoryStream *image, size_t data_offset, Bitmap *screenshot, const color *pal)
+{
+    Stream *out = Common::File::CreateFile(path);
+    if (out == NULL)
+        return false;
+
+    // Everything before the compressed data is copied as it is
+    bool ok = out->Write(image->GetData(), data_offset) == data_offset;
+    image->Seek(Common::kSeekBegin, data_offset);
+    ok = ok && CompressedStream::PackBlocks(image, out);
+
+    if (ok && screenshot != NULL)
+    {
+        int screenShotOffset = out->GetPosition() - sizeof(RICH_GAME_MEDIA_HEADER);
+        int screenShotSize = write_screen_shot_for_vista(out, screenshot, pal);
+        out->Seek(Common::kSeekBegin, 12);
+        out->WriteInt32(screenShotOffset);
+        out->Seek(Common::kSeekCurrent, 4);
+        out->WriteInt32(screenShotSize);
+    }
+
+    ok = ok && out->Flush();
+    delete out;
+    return ok;
+}
+
+// Only saves written in background report back to the script; games
+// made before these events do not expect them after SaveGameSlot
+void on_game_saved(int slotn, bool success)
+{
+    // The restart point is not saved at the player's request
+    if (slotn == RESTART_POINT_SAVE_GAME_NUMBER)
+        return;
+    run_on_event(success ? GE_SAVE_GAME : GE_SAVE_GAME_FAILED, RuntimeScriptValue().SetInt32(slotn));
+}
+
 char rbuffer[200];
 
 Bitmap *restore_game_screenshot(Stream *in)
@@ -1736,7 +1908,7 @@ void ReadRoomStatus_Aligned(RoomStatus *roomstat, Stream *in)
     roomstat->ReadFromFile_v321(&align_s);
 }
 
-void restore_game_room_state(Stream *in, const char *nametouse)
+void restore_game_room_state(Stream *in, const char *nametouse, SavedGameVersion svg_version)
 {
     int vv;
 
@@ -1746,6 +1918,14 @@ void restore_game_room_state(Stream *in, const char *nametouse)
     resetRoomStatuses();
 
     // read the room state for all the rooms the player has been in
+    MemoryStream blank_image;
+    MemoryStream room_image;
+    uint8_t *room_data = NULL;
+    if (svg_version >= kSvgVersion_RoomDelta)
+    {
+        write_blank_room_status(&blank_image);
+        room_data = new uint8_t[blank_image.GetLength()];
+    }
     RoomStatus* roomstat;
     int beenhere;
     for (vv=0;vv<MAX_ROOMS;vv++)
@@ -1762,15 +1942,36 @@ void restore_game_room_state(Stream *in, const char *nametouse)
 
             if (roomstat->beenhere)
             {
-                ReadRoomStatus_Aligned(roomstat, in);
+                if (svg_version >= kSvgVersion_RoomDelta)
+                {
+                    memcpy(room_data, blank_image.GetData(), blank_image.GetLength());
+                    read_data_delta(room_data, blank_image.GetLength(), in);
+                    room_image.Clear();
+                    room_image.Write(room_data, blank_image.GetLength());
+                    room_image.Seek(Common::kSeekBegin, 0);
+                    ReadRoomStatus_Aligned(roomstat, &room_image);
+                }
+                else
+                {
+                    ReadRoomStatus_Aligned(roomstat, in);
+                }
                 if (roomstat->tsdatasize > 0)
                 {
                     roomstat->tsdata=(char*)malloc(roomstat->tsdatasize + 8);  // JJS: Why allocate 8 additional bytes?
-                    in->Read(&roomstat->tsdata[0], roomstat->tsdatasize);
+                    if (svg_version >= kSvgVersion_RoomDelta)
+                    {
+                        memset(roomstat->tsdata, 0, roomstat->tsdatasize);
+                        read_data_delta((uint8_t*)roomstat->tsdata, roomstat->tsdatasize, in);
+                    }
+                    else
+                    {
+                        in->Read(&roomstat->tsdata[0], roomstat->tsdatasize);
+                    }
                 }
             }
         }
     }
+    delete [] room_data;
 }
 
 void ReadGameState_Aligned(Stream *in)
@@ -2073,6 +2274,7 @@ void restore_game_audioclips_and_crossfade(Stream *in, int crossfadeInChannelWas
             play_audio_clip_on_channel(bb, &game.audioClips[audioClipIndex], priority, repeat, channelPositions[bb]);
             if (channels[bb] != NULL)
             {
+                AGS::Engine::MutexLock _lock(_audio_poll_mutex);
                 channels[bb]->set_panning(pan);
                 channels[bb]->set_volume_alternate(volAsPercent, vol);
                 channels[bb]->panningAsPercentage = panAsPercent;
@@ -2090,6 +2292,7 @@ void restore_game_audioclips_and_crossfade(Stream *in, int crossfadeInChannelWas
     {
         if ((channelPositions[bb] > 0) && (channels[bb] != NULL) && (channels[bb]->done == 0))
         {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             channels[bb]->seek(channelPositions[bb]);
         }
     }
@@ -2125,7 +2328,7 @@ int restore_game_data (Stream *in, const char *nametouse, SavedGameVersion svg_v
     char *scriptModuleDataBuffers[MAX_SCRIPT_MODULES];
     int scriptModuleDataSize[MAX_SCRIPT_MODULES];
     restore_game_scripts(in, /*out*/ gdatasize,&newglobaldatabuffer, scriptModuleDataBuffers, scriptModuleDataSize);
-    restore_game_room_state(in, nametouse);
+    restore_game_room_state(in, nametouse, svg_version);
 
     restore_game_play(in);
 
@@ -2225,7 +2428,13 @@ int restore_game_data (Stream *in, const char *nametouse, SavedGameVersion svg_v
     recache_queued_clips_after_loading_save_game();
 
     // [IKM] Plugins expect FILE pointer! // TODO something with this later
-    platform->RunPluginHooks(AGSE_RESTOREGAME, (long)((Common::FileStream*)in)->GetHandle());
+    // The data the plugins wrote follows the last block read; the game
+    // is only restored from memory if no plugin wants to read there
+    Stream *plugin_in = in;
+    if (svg_version >= kSvgVersion_Compressed)
+        plugin_in = ((CompressedStream*)in)->GetBaseStream();
+    if (pl_any_want_hook(AGSE_RESTOREGAME))
+        platform->RunPluginHooks(AGSE_RESTOREGAME, (long)((Common::FileStream*)plugin_in)->GetHandle());
     if (in->ReadInt32() != (unsigned)MAGICNUMBER)
         quit("!One of the game plugins did not restore its game data correctly.");
 
@@ -2335,6 +2544,8 @@ int restore_game_data (Stream *in, const char *nametouse, SavedGameVersion svg_v
     }
 
     gui_disabled_style = convert_gui_disabled_style(game.options[OPT_DISABLEOFF]);
+    // text may now be written in the other direction
+    invalidate_text_layout_cache();
     /*
     play_sound(-1);
 
@@ -2411,7 +2622,21 @@ int restore_game_data (Stream *in, const char *nametouse, SavedGameVersion svg_v
 
 int restore_game_data (Common::Stream *in, const char *nametouse)
 {
-    return restore_game_data (in, nametouse, kSvgVersion_321);
+    // The replays store the game as save_game_data wrote it
+    SavedGameVersion svg_version = (SavedGameVersion)in->ReadInt32();
+    if (svg_version < kSvgVersion_LowestSupported || svg_version > kSvgVersion_Current)
+        return -3;
+
+    Stream *data_in = in;
+    if (svg_version >= kSvgVersion_Compressed)
+        data_in = new CompressedStream(in, Common::kFile_Read);
+    delete restore_game_screenshot(data_in);
+    int error_code = restore_game_header(data_in);
+    if (error_code == 0)
+        error_code = restore_game_data(data_in, nametouse, svg_version);
+    if (data_in != in)
+        delete data_in;
+    return error_code;
 }
 
 int gameHasBeenRestored = 0;
@@ -2423,8 +2648,12 @@ void ReadRichMediaHeader_Aligned(RICH_GAME_MEDIA_HEADER &rich_media_header, Stre
     rich_media_header.ReadFromFile(&align_s);
 }
 
-Stream *open_savedgame(const char *savedgame, int &error_code, SavedGameVersion *out_svg_version = NULL)
+Stream *open_savedgame(const char *savedgame, int &error_code, SavedGameVersion *out_svg_version = NULL,
+                       SavegameInfo *out_info = NULL)
 {
+    // The file may be still being written in background
+    wait_for_async_save();
+
     error_code = 0;
     Stream *in = Common::File::OpenFileRead(savedgame);
     if (!in)
@@ -2454,6 +2683,12 @@ Stream *open_savedgame(const char *savedgame, int &error_code, SavedGameVersion
     fgetstring_limit(rbuffer, in, 180);
     rbuffer[180] = 0;
     safeguard_string ((unsigned char*)rbuffer);
+    if (out_info)
+    {
+        out_info->Description = rbuffer;
+        out_info->ThumbnailOffset = rich_media_header.dwThumbnailOffsetLowerDword;
+        out_info->ThumbnailSize = rich_media_header.dwThumbnailSize;
+    }
 
     // check saved game format version
     SavedGameVersion svg_version = (SavedGameVersion)in->ReadInt32();
@@ -2468,18 +2703,30 @@ Stream *open_savedgame(const char *savedgame, int &error_code, SavedGameVersion
         return NULL;
     }
 
+    if (svg_version >= kSvgVersion_Compressed)
+    {
+        in = new CompressedStream(in, Common::kFile_Read, Common::kDisposeAfterUse);
+    }
     return in;
 }
 
 int read_savedgame_description(const String &savedgame, String &description)
 {
+    SavegameInfo info;
+    if (get_indexed_savegame_info(savedgame, info))
+    {
+        description = info.Description;
+        return 0;
+    }
+
     int error_code;
     // yeah, I know what you think... this will be remade someday
-    delete open_savedgame(savedgame, error_code);
+    delete open_savedgame(savedgame, error_code, NULL, &info);
     if (error_code == 0)
     {
         description = rbuffer;
         our_eip = oldeip;
+        index_savegame_info(savedgame, info);
     }
     return error_code;
 }
@@ -2488,14 +2735,23 @@ int read_savedgame_screenshot(const String &savedgame, int &want_shot)
 {
     want_shot = 0;
 
+    // The saved games known to have no screenshot need not be opened
+    SavegameInfo info;
+    if (get_indexed_savegame_info(savedgame, info) && info.HasScreenshot == 0)
+    {
+        return 0;
+    }
+
     int error_code;
-    Stream *in = open_savedgame(savedgame, error_code);
+    Stream *in = open_savedgame(savedgame, error_code, NULL, &info);
     if (!in)
     {
         return error_code;
     }
 
     Bitmap *screenshot = restore_game_screenshot(in);
+    info.HasScreenshot = screenshot ? 1 : 0;
+    index_savegame_info(savedgame, info);
     if (screenshot)
     {
         int slot = spriteset.findFreeSlot();
@@ -2622,6 +2878,7 @@ void stop_fast_forwarding() {
             (channels[aa]->volAsPercentage == 0) &&
             (channels[aa]->originalVolAsPercentage > 0))
         {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             channels[aa]->reset_volume_to_origin();
         }
     }
@@ -2727,6 +2984,7 @@ void display_switch_out_suspend()
     // stop the sound stuttering
     for (int i = 0; i <= MAX_SOUND_CHANNELS; i++) {
         if ((channels[i] != NULL) && (channels[i]->done == 0)) {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             channels[i]->pause();
         }
     }
@@ -2753,6 +3011,7 @@ void display_switch_in_resume()
 
     for (int i = 0; i <= MAX_SOUND_CHANNELS; i++) {
         if ((channels[i] != NULL) && (channels[i]->done == 0)) {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             channels[i]->resume();
         }
     }
@@ -2967,6 +3226,18 @@ RuntimeScriptValue Sc_Game_InputBox(const RuntimeScriptValue *params, int32_t pa
     API_SCALL_OBJ_POBJ(const char, myScriptStringImpl, Game_InputBox, const char);
 }
 
+// void (int index)
+RuntimeScriptValue Sc_Game_RestoreSnapshot(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_VOID_PINT(restore_game_snapshot);
+}
+
+// void ()
+RuntimeScriptValue Sc_Game_SaveSnapshot(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_VOID(save_game_snapshot);
+}
+
 // int (const char *newFolder)
 RuntimeScriptValue Sc_Game_SetSaveGameDirectory(const RuntimeScriptValue *params, int32_t param_count)
 {
@@ -3099,6 +3370,12 @@ RuntimeScriptValue Sc_Game_GetSkippingCutscene(const RuntimeScriptValue *params,
     API_SCALL_INT(Game_GetSkippingCutscene);
 }
 
+// int ()
+RuntimeScriptValue Sc_Game_GetSnapshotCount(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_INT(get_game_snapshot_count);
+}
+
 // int ()
 RuntimeScriptValue Sc_Game_GetSpeechFont(const RuntimeScriptValue *params, int32_t param_count)
 {
@@ -3171,6 +3448,8 @@ void RegisterGameAPI()
     ccAddExternalStaticFunction("Game::GetSaveSlotDescription^1",               Sc_Game_GetSaveSlotDescription);
     ccAddExternalStaticFunction("Game::GetViewFrame^3",                         Sc_Game_GetViewFrame);
     ccAddExternalStaticFunction("Game::InputBox^1",                             Sc_Game_InputBox);
+    ccAddExternalStaticFunction("Game::RestoreSnapshot^1",                      Sc_Game_RestoreSnapshot);
+    ccAddExternalStaticFunction("Game::SaveSnapshot^0",                         Sc_Game_SaveSnapshot);
     ccAddExternalStaticFunction("Game::SetSaveGameDirectory^1",                 Sc_Game_SetSaveGameDirectory);
     ccAddExternalStaticFunction("Game::StopSound^1",                            Sc_StopAllSounds);
     ccAddExternalStaticFunction("Game::get_CharacterCount",                     Sc_Game_GetCharacterCount);
@@ -3193,6 +3472,7 @@ void RegisterGameAPI()
     ccAddExternalStaticFunction("Game::get_NormalFont",                         Sc_Game_GetNormalFont);
     ccAddExternalStaticFunction("Game::set_NormalFont",                         Sc_SetNormalFont);
     ccAddExternalStaticFunction("Game::get_SkippingCutscene",                   Sc_Game_GetSkippingCutscene);
+    ccAddExternalStaticFunction("Game::get_SnapshotCount",                      Sc_Game_GetSnapshotCount);
     ccAddExternalStaticFunction("Game::get_SpeechFont",                         Sc_Game_GetSpeechFont);
     ccAddExternalStaticFunction("Game::set_SpeechFont",                         Sc_SetSpeechFont);
     ccAddExternalStaticFunction("Game::geti_SpriteWidth",                       Sc_Game_GetSpriteWidth);
@@ -3220,6 +3500,8 @@ void RegisterGameAPI()
     ccAddExternalFunctionForPlugin("Game::GetSaveSlotDescription^1",               (void*)Game_GetSaveSlotDescription);
     ccAddExternalFunctionForPlugin("Game::GetViewFrame^3",                         (void*)Game_GetViewFrame);
     ccAddExternalFunctionForPlugin("Game::InputBox^1",                             (void*)Game_InputBox);
+    ccAddExternalFunctionForPlugin("Game::RestoreSnapshot^1",                      (void*)restore_game_snapshot);
+    ccAddExternalFunctionForPlugin("Game::SaveSnapshot^0",                         (void*)save_game_snapshot);
     ccAddExternalFunctionForPlugin("Game::SetSaveGameDirectory^1",                 (void*)Game_SetSaveGameDirectory);
     ccAddExternalFunctionForPlugin("Game::StopSound^1",                            (void*)StopAllSounds);
     ccAddExternalFunctionForPlugin("Game::get_CharacterCount",                     (void*)Game_GetCharacterCount);
@@ -3242,6 +3524,7 @@ void RegisterGameAPI()
     ccAddExternalFunctionForPlugin("Game::get_NormalFont",                         (void*)Game_GetNormalFont);
     ccAddExternalFunctionForPlugin("Game::set_NormalFont",                         (void*)SetNormalFont);
     ccAddExternalFunctionForPlugin("Game::get_SkippingCutscene",                   (void*)Game_GetSkippingCutscene);
+    ccAddExternalFunctionForPlugin("Game::get_SnapshotCount",                      (void*)get_game_snapshot_count);
     ccAddExternalFunctionForPlugin("Game::get_SpeechFont",                         (void*)Game_GetSpeechFont);
     ccAddExternalFunctionForPlugin("Game::set_SpeechFont",                         (void*)SetSpeechFont);
     ccAddExternalFunctionForPlugin("Game::geti_SpriteWidth",                       (void*)Game_GetSpriteWidth);
@@ -24,7 +24,8 @@
 #include "main/game_file.h"
 
 // Forward declaration
-namespace AGS { namespace Common { class Bitmap; class Stream; class String; } }
+namespace AGS { namespace Common { class Bitmap; class MemoryStream; class Stream; class String; } }
+struct RGB;
 using namespace AGS; // FIXME later
 
 #define RAGMODE_PRESERVEGLOBALINT 1
@@ -124,8 +125,16 @@ GameFileError load_game_file();
 void free_do_once_tokens();
 // Free all the memory associated with the game
 void unload_game_file();
-void save_game_data (Common::Stream *out, Common::Bitmap *screenshot);
+// Writes the game state; if compress is false, the data blocks are stored
+// uncompressed, to be compressed by write_savegame_image
+void save_game_data (Common::Stream *out, Common::Bitmap *screenshot, bool compress = true);
 void save_game(int slotn, const char*descript);
+// Writes the savegame which save_game has put into memory to the file;
+// does not touch the game state, so may be run on another thread
+bool write_savegame_image(const Common::String &path, Common::MemoryStream *image, size_t data_offset,
+                          Common::Bitmap *screenshot, const RGB *pal);
+// Tells the script whether the game was saved into the slot
+void on_game_saved(int slotn, bool success);
 int  restore_game_data (Common::Stream *in, const char *nametouse);
 int read_savedgame_description(const Common::String &savedgame, Common::String &description);
 int read_savedgame_screenshot(const Common::String &savedgame, int &want_shot);
@@ -136,7 +145,7 @@ void safeguard_string (Common::String &descript);
 // On Windows we could just use IIDFromString but this is platform-independant
 void convert_guid_from_text_to_binary(const char *guidText, unsigned char *buffer);
 Common::Bitmap *read_serialized_bitmap(Common::Stream *in);
-long write_screen_shot_for_vista(Common::Stream *out, Common::Bitmap *screenshot);
+long write_screen_shot_for_vista(Common::Stream *out, Common::Bitmap *screenshot, const RGB *pal);
 
 void start_skipping_cutscene ();
 void check_skip_cutscene_keypress (int kgn);
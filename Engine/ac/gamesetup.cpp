@@ -32,6 +32,9 @@ GameSetup::GameSetup()
     prefer_letterbox = true;
     base_width = 320;
     base_height = 200;
+    gfx_dump_interval = 0;
+    frame_timing = false;
+    frame_timing_interval = 0;
     mouse_auto_lock = false;
     override_script_os = -1;
     override_multitasking = -1;
@@ -39,4 +42,11 @@ GameSetup::GameSetup()
     mouse_speed = 1.f;
     mouse_control = kMouseCtrl_Fullscreen;
     mouse_speed_def = kMouseSpeed_CurrentDisplay;
+    pathfinder = kPathfinder_Legacy;
+    async_audio_types = 0;
+    decoded_sound_cache_size = 16 * 1024 * 1024;
+    decoded_sound_max_length = 5000;
+    async_save = true;
+    snapshot_count = 8;
+    snapshot_interval = 0;
 }
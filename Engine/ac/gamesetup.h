@@ -34,6 +34,14 @@ enum MouseSpeedDef
     kNumMouseSpeedDefs
 };
 
+// Route finding algorithm used for walking characters
+enum PathfinderType
+{
+    kPathfinder_Legacy,     // original search, kept for compatibility
+    kPathfinder_AStar,      // A* search over the walkable areas
+    kNumPathfinderTypes
+};
+
 struct GameSetup {
     int digicard;
     int midicard;
@@ -57,6 +65,13 @@ struct GameSetup {
     AGS::Common::String translation;
     AGS::Common::String gfxFilterID;
     AGS::Common::String gfxDriverID;
+    int   gfx_dump_interval; // null driver: save every N-th frame as image
+    AGS::Common::String gfx_dump_dir; // null driver: where to save frame images
+    AGS::Common::String gfx_timing_file; // null driver: file for per-frame timings
+    bool  frame_timing; // measure and display game loop phase timings
+    int   frame_timing_interval; // number of frames between timing dumps
+    AGS::Common::String frame_timing_file; // file to write timing percentiles to
+    AGS::Common::String trace_file; // file to write activity trace to; empty disables tracing
     bool  mouse_auto_lock;
     int   override_script_os;
     char  override_multitasking;
@@ -64,6 +79,13 @@ struct GameSetup {
     float mouse_speed;
     MouseControl mouse_control;
     MouseSpeedDef mouse_speed_def;
+    PathfinderType pathfinder;
+    int   async_audio_types; // bit mask of audio types whose clips are loaded in background
+    int   decoded_sound_cache_size; // memory budget for decoded short clips, in bytes
+    int   decoded_sound_max_length; // longest clip to keep decoded, in milliseconds
+    bool  async_save; // write saved games to disk on a separate thread
+    int   snapshot_count; // number of game snapshots kept in memory
+    int   snapshot_interval; // seconds between periodic snapshots; 0 disables them
     GameSetup();
 };
 
@@ -0,0 +1,154 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "ac/gamesnapshot.h"
+#include "util/wgt2allg.h"
+#include "ac/common.h"
+#include "ac/event.h"
+#include "ac/game.h"
+#include "ac/gamesetup.h"
+#include "debug/debug_log.h"
+#include "debug/tracer.h"
+#include "plugin/agsplugin.h"
+#include "script/executingscript.h"
+#include "script/script.h"
+#include "util/memorystream.h"
+
+using AGS::Common::MemoryStream;
+
+extern GameSetup usetup;
+extern int displayed_room;
+extern int game_paused;
+extern int frames_per_second;
+extern unsigned int loopcounter;
+extern int gameHasBeenRestored;
+extern const char *load_game_errors[9];
+
+MemoryStream **snapshots = NULL;    // ring buffer of the snapshots
+int  snapshot_capacity = 0;
+int  snapshot_newest = -1;          // index of the most recent snapshot
+int  snapshot_count = 0;
+unsigned int next_snapshot_loop = 0; // game loop to take the periodic snapshot at
+
+bool can_save_game_snapshot()
+{
+    if (usetup.snapshot_count <= 0)
+        return false;
+    // Plugins read and write their data straight from the file
+    return !pl_any_want_hook(AGSE_SAVEGAME) && !pl_any_want_hook(AGSE_RESTOREGAME);
+}
+
+void schedule_periodic_snapshot()
+{
+    if (usetup.snapshot_interval > 0)
+        next_snapshot_loop = loopcounter + usetup.snapshot_interval * frames_per_second;
+}
+
+void take_game_snapshot()
+{
+    TraceScope trace("save", "save_game_snapshot");
+    if (snapshots == NULL)
+    {
+        snapshot_capacity = usetup.snapshot_count;
+        snapshots = new MemoryStream*[snapshot_capacity];
+        for (int i = 0; i < snapshot_capacity; ++i)
+            snapshots[i] = NULL;
+    }
+
+    // The oldest snapshot is replaced when all are used; its memory is
+    // kept, since the new one is likely to be about as large
+    snapshot_newest = (snapshot_newest + 1) % snapshot_capacity;
+    if (snapshot_count < snapshot_capacity)
+        snapshot_count++;
+    if (snapshots[snapshot_newest] == NULL)
+        snapshots[snapshot_newest] = new MemoryStream();
+    MemoryStream *out = snapshots[snapshot_newest];
+    out->Clear();
+    save_game_data(out, NULL);
+    schedule_periodic_snapshot();
+}
+
+void save_game_snapshot()
+{
+    // the state of blocked scripts is not saved, same as with save_game
+    can_run_delayed_command();
+
+    if (inside_script) {
+        curscript->queue_action(ePSASaveSnapshot, 0, "Game.SaveSnapshot");
+        return;
+    }
+
+    if (!can_save_game_snapshot()) {
+        debug_log("Game.SaveSnapshot: game snapshots are disabled or not supported by the plugins this game uses");
+        return;
+    }
+    take_game_snapshot();
+}
+
+void restore_game_snapshot(int index)
+{
+    if (displayed_room < 0)
+        quit("!Game.RestoreSnapshot: a game cannot be restored from within game_start");
+    if (index < 0 || index >= snapshot_count)
+        quitprintf("!Game.RestoreSnapshot: invalid snapshot index %d, there are %d snapshots", index, snapshot_count);
+
+    can_run_delayed_command();
+    if (inside_script) {
+        curscript->queue_action(ePSARestoreSnapshot, index, "Game.RestoreSnapshot");
+        return;
+    }
+
+    TraceScope trace("save", "restore_game_snapshot", "index", index);
+    gameHasBeenRestored++;
+    MemoryStream *in = snapshots[(snapshot_newest - index + snapshot_capacity) % snapshot_capacity];
+    in->Seek(Common::kSeekBegin, 0);
+    int error_code = restore_game_data(in, "");
+    if (error_code)
+        quitprintf("!Game.RestoreSnapshot: unable to restore the game (error: %s)", load_game_errors[-error_code]);
+    schedule_periodic_snapshot();
+
+    // There is no save slot to pass to the script
+    run_on_event(GE_RESTORE_GAME, RuntimeScriptValue().SetInt32(-1));
+
+    // ensure keyboard buffer is clean, same as load_game does
+    while (keypressed()) readkey();
+}
+
+int get_game_snapshot_count()
+{
+    return snapshot_count;
+}
+
+void update_game_snapshots()
+{
+    if (usetup.snapshot_interval <= 0 || loopcounter < next_snapshot_loop)
+        return;
+    // Only take the snapshot where the game could be saved by the player
+    if (inside_script || displayed_room < 0 || game_paused)
+        return;
+    if (!can_save_game_snapshot())
+        return;
+    take_game_snapshot();
+}
+
+void free_game_snapshots()
+{
+    for (int i = 0; i < snapshot_capacity; ++i)
+        delete snapshots[i];
+    delete [] snapshots;
+    snapshots = NULL;
+    snapshot_capacity = 0;
+    snapshot_newest = -1;
+    snapshot_count = 0;
+}
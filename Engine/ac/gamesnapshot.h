@@ -0,0 +1,40 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Game snapshots: saved games kept in memory.
+//
+// A snapshot is the game state in the form save_game_data writes it. The
+// engine keeps a number of the most recent snapshots, replacing the oldest
+// one when a new one is taken, and restores the game from them without
+// going through the files. Besides the snapshots made on request, the game
+// may be captured periodically, which allows to rewind it.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__GAMESNAPSHOT_H
+#define __AGS_EE_AC__GAMESNAPSHOT_H
+
+// Tells whether the game state can be kept in memory
+bool can_save_game_snapshot();
+// Saves the game state into a new snapshot
+void save_game_snapshot();
+// Restores the game from the snapshot; index 0 is the most recent one
+void restore_game_snapshot(int index);
+// Returns the number of snapshots kept
+int  get_game_snapshot_count();
+// Takes the periodic snapshot when it is time to
+void update_game_snapshots();
+// Frees all the snapshots
+void free_game_snapshots();
+
+#endif // __AGS_EE_AC__GAMESNAPSHOT_H
@@ -162,6 +162,7 @@ int PlaySoundEx(int val1, int channel) {
         return -1;
     }
 
+    AGS::Engine::MutexLock _lock(_audio_poll_mutex);
     channels[channel] = soundfx;
     channels[channel]->priority = 10;
     channels[channel]->set_volume (play.sound_volume);
@@ -335,7 +336,10 @@ void SetChannelVolume(int chan, int newvol) {
             update_ambient_sound_vol();
         }
         else
+        {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             channels[chan]->set_volume (newvol);
+        }
     }
 }
 
@@ -412,7 +416,10 @@ void SetSpeechVolume(int newvol) {
         quit("!SetSpeechVolume: invalid volume - must be from 0-255");
 
     if (channels[SCHAN_SPEECH])
+    {
+        AGS::Engine::MutexLock _lock(_audio_poll_mutex);
         channels[SCHAN_SPEECH]->set_volume (newvol);
+    }
 
     play.speech_volume = newvol;
 }
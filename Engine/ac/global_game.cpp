@@ -15,6 +15,7 @@
 #define USE_CLIB
 #include <stdio.h>
 #include "ac/global_game.h"
+#include "ac/asyncsave.h"
 #include "ac/common.h"
 #include "ac/view.h"
 #include "ac/character.h"
@@ -40,9 +41,11 @@
 #include "ac/room.h"
 #include "ac/roomstatus.h"
 #include "ac/roomstruct.h"
+#include "ac/savegameindex.h"
 #include "ac/string.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
+#include "font/textlayoutcache.h"
 #include "gui/guidialog.h"
 #include "main/engine.h"
 #include "main/game_start.h"
@@ -126,8 +129,10 @@ void RestoreGameSlot(int slnum) {
 }
 
 void DeleteSaveSlot (int slnum) {
+    wait_for_async_save();
     String nametouse;
     nametouse = get_save_game_path(slnum);
+    forget_savegame_info(nametouse);
     unlink (nametouse);
     if ((slnum >= 1) && (slnum <= MAXSAVEGAMES)) {
         String thisname;
@@ -135,6 +140,7 @@ void DeleteSaveSlot (int slnum) {
             thisname = get_save_game_path(i);
             if (Common::File::TestReadFile(thisname)) {
                 // Rename the highest save game to fill in the gap
+                forget_savegame_info(thisname);
                 rename (thisname, nametouse);
                 break;
             }
@@ -428,6 +434,8 @@ int SetGameOption (int opt, int setting) {
         if (setting == 0)  // set back to Left
             play.swap_portrait_side = 0;
     }
+    else if (opt == OPT_RIGHTLEFTWRITE)
+        invalidate_text_layout_cache();
 
     return oldval;
 }
@@ -76,6 +76,11 @@ int GetObjectAt(int xx,int yy) {
         int isflipped = 0;
         int spWidth = divide_down_coordinate(objs[aa].get_width());
         int spHeight = divide_down_coordinate(objs[aa].get_height());
+        // Test the bounding box before getting the image, which may have to
+        // be loaded into the sprite cache
+        if ((spWidth != 0) && (spHeight != 0) &&
+            (isposinbox(xx, yy, xxx, yyy - spHeight, xxx + spWidth, yyy) == FALSE))
+            continue;
         if (objs[aa].view >= 0)
             isflipped = views[objs[aa].view].loops[objs[aa].loop].frames[objs[aa].frame].flags & VFLG_FLIPSPRITE;
 
@@ -17,6 +17,7 @@
 #include "ac/common.h"
 #include "ac/draw.h"
 #include "ac/region.h"
+#include "ac/roommask.h"
 #include "ac/roomstatus.h"
 #include "ac/roomstruct.h"
 #include "debug/debug_log.h"
@@ -49,7 +50,7 @@ int GetRegionAt (int xxx, int yyy) {
             yyy = 0;
     }
 
-    int hsthere = thisroom.regions->GetPixel (xxx, yyy);
+    int hsthere = get_mask_pixel(thisroom.regions, xxx, yyy);
     if (hsthere < 0)
         hsthere = 0;
 
@@ -130,7 +130,7 @@ void GUI_SetSize(ScriptGUI *sgui, int widd, int hitt) {
   
   recreate_guibg_image(tehgui);
 
-  guis_need_update = 1;
+  tehgui->mark_changed();
 }
 
 int GUI_GetWidth(ScriptGUI *sgui) {
@@ -209,7 +209,7 @@ void GUI_Centre(ScriptGUI *sgui) {
 void GUI_SetBackgroundGraphic(ScriptGUI *tehgui, int slotn) {
   if (guis[tehgui->id].bgpic != slotn) {
     guis[tehgui->id].bgpic = slotn;
-    guis_need_update = 1;
+    guis[tehgui->id].mark_changed();
   }
 }
 
@@ -241,7 +241,7 @@ void remove_popup_interface(int ifacenum) {
         set_default_cursor();
 
     if (ifacenum==mouse_on_iface) mouse_on_iface=-1;
-    guis_need_update = 1;
+    guis[ifacenum].mark_changed();
 }
 
 void process_interface_click(int ifce, int btn, int mbut) {
@@ -66,7 +66,7 @@ void GUIControl_SetVisible(GUIObject *guio, int visible)
       guio->Hide();
 
     guis[guio->guin].control_positions_changed();
-    guis_need_update = 1;
+    guio->MarkChanged();
   }
 }
 
@@ -83,7 +83,7 @@ void GUIControl_SetClickable(GUIObject *guio, int enabled) {
     guio->SetClickable(false);
 
   guis[guio->guin].control_positions_changed();
-  guis_need_update = 1;
+  guio->MarkChanged();
 }
 
 int GUIControl_GetEnabled(GUIObject *guio) {
@@ -99,7 +99,7 @@ void GUIControl_SetEnabled(GUIObject *guio, int enabled) {
     guio->Disable();
 
   guis[guio->guin].control_positions_changed();
-  guis_need_update = 1;
+  guio->MarkChanged();
 }
 
 
@@ -160,7 +160,7 @@ int GUIControl_GetX(GUIObject *guio) {
 void GUIControl_SetX(GUIObject *guio, int xx) {
   guio->x = multiply_up_coordinate(xx);
   guis[guio->guin].control_positions_changed();
-  guis_need_update = 1;
+  guio->MarkChanged();
 }
 
 int GUIControl_GetY(GUIObject *guio) {
@@ -170,7 +170,7 @@ int GUIControl_GetY(GUIObject *guio) {
 void GUIControl_SetY(GUIObject *guio, int yy) {
   guio->y = multiply_up_coordinate(yy);
   guis[guio->guin].control_positions_changed();
-  guis_need_update = 1;
+  guio->MarkChanged();
 }
 
 void GUIControl_SetPosition(GUIObject *guio, int xx, int yy) {
@@ -187,7 +187,7 @@ void GUIControl_SetWidth(GUIObject *guio, int newwid) {
   guio->wid = multiply_up_coordinate(newwid);
   guio->Resized();
   guis[guio->guin].control_positions_changed();
-  guis_need_update = 1;
+  guio->MarkChanged();
 }
 
 int GUIControl_GetHeight(GUIObject *guio) {
@@ -198,7 +198,7 @@ void GUIControl_SetHeight(GUIObject *guio, int newhit) {
   guio->hit = multiply_up_coordinate(newhit);
   guio->Resized();
   guis[guio->guin].control_positions_changed();
-  guis_need_update = 1;
+  guio->MarkChanged();
 }
 
 void GUIControl_SetSize(GUIObject *guio, int newwid, int newhit) {
@@ -212,12 +212,12 @@ void GUIControl_SetSize(GUIObject *guio, int newwid, int newhit) {
 
 void GUIControl_SendToBack(GUIObject *guio) {
   if (guis[guio->guin].send_to_back(guio->objn))
-    guis_need_update = 1;
+    guio->MarkChanged();
 }
 
 void GUIControl_BringToFront(GUIObject *guio) {
   if (guis[guio->guin].bring_to_front(guio->objn))
-    guis_need_update = 1;
+    guio->MarkChanged();
 }
 
 //=============================================================================
@@ -18,6 +18,7 @@
 #include "ac/global_hotspot.h"
 #include "ac/global_translation.h"
 #include "ac/properties.h"
+#include "ac/roommask.h"
 #include "ac/roomstatus.h"
 #include "ac/string.h"
 #include "gfx/bitmap.h"
@@ -90,7 +91,7 @@ const char* Hotspot_GetTextProperty(ScriptHotspot *hss, const char *property) {
 }
 
 int get_hotspot_at(int xpp,int ypp) {
-    int onhs=thisroom.lookat->GetPixel(convert_to_low_res(xpp), convert_to_low_res(ypp));
+    int onhs=get_mask_pixel(thisroom.lookat, convert_to_low_res(xpp), convert_to_low_res(ypp));
     if (onhs<0) return 0;
     if (croom->hotspot_enabled[onhs]==0) return 0;
     return onhs;
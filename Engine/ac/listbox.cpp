@@ -15,6 +15,7 @@
 #include <set>
 #include <stdio.h>
 #include "ac/listbox.h"
+#include "ac/asyncsave.h"
 #include "ac/common.h"
 #include "ac/file.h"
 #include "ac/gamesetupstruct.h"
@@ -23,7 +24,6 @@
 #include "ac/string.h"
 #include "gui/guimain.h"
 
-extern int guis_need_update;
 extern char saveGameDirectory[260];
 extern GameState play;
 extern GUIMain*guis;
@@ -35,7 +35,7 @@ int ListBox_AddItem(GUIListBox *lbb, const char *text) {
   if (lbb->AddItem(text) < 0)
     return 0;
 
-  guis_need_update = 1;
+  lbb->MarkChanged();
   return 1;
 }
 
@@ -43,13 +43,13 @@ int ListBox_InsertItemAt(GUIListBox *lbb, int index, const char *text) {
   if (lbb->InsertItem(index, text) < 0)
     return 0;
 
-  guis_need_update = 1;
+  lbb->MarkChanged();
   return 1;
 }
 
 void ListBox_Clear(GUIListBox *listbox) {
   listbox->Clear();
-  guis_need_update = 1;
+  listbox->MarkChanged();
 }
 
 void FillDirList(std::set<String> &files, const String &path)
@@ -65,7 +65,7 @@ void FillDirList(std::set<String> &files, const String &path)
 
 void ListBox_FillDirList(GUIListBox *listbox, const char *filemask) {
   listbox->Clear();
-  guis_need_update = 1;
+  listbox->MarkChanged();
 
   String path, alt_path;
   if (!ResolveScriptPath(filemask, true, path, alt_path))
@@ -91,6 +91,8 @@ int ListBox_GetSaveGameSlots(GUIListBox *listbox, int index) {
 
 int ListBox_FillSaveGameList(GUIListBox *listbox) {
   listbox->Clear();
+  // make sure that the game being saved is in the list
+  wait_for_async_save();
 
   int numsaves=0;
   int bufix=0;
@@ -144,7 +146,7 @@ int ListBox_FillSaveGameList(GUIListBox *listbox) {
     play.filenumbers[nn] = listbox->saveGameIndex[nn];
   }
 
-  guis_need_update = 1;
+  listbox->MarkChanged();
   listbox->exflags |= GLF_SGINDEXVALID;
 
   if (numsaves >= MAXSAVEGAMES)
@@ -188,7 +190,7 @@ void ListBox_SetItemText(GUIListBox *listbox, int index, const char *newtext) {
 
   if (strcmp(listbox->items[index], newtext)) {
     listbox->SetItemText(index, newtext);
-    guis_need_update = 1;
+    listbox->MarkChanged();
   }
 }
 
@@ -198,7 +200,7 @@ void ListBox_RemoveItem(GUIListBox *listbox, int itemIndex) {
     quit("!ListBoxRemove: invalid listindex specified");
 
   listbox->RemoveItem(itemIndex);
-  guis_need_update = 1;
+  listbox->MarkChanged();
 }
 
 int ListBox_GetItemCount(GUIListBox *listbox) {
@@ -216,7 +218,7 @@ void ListBox_SetFont(GUIListBox *listbox, int newfont) {
 
   if (newfont != listbox->font) {
     listbox->ChangeFont(newfont);
-    guis_need_update = 1;
+    listbox->MarkChanged();
   }
 
 }
@@ -229,7 +231,7 @@ void ListBox_SetHideBorder(GUIListBox *listbox, int newValue) {
   listbox->exflags &= ~GLF_NOBORDER;
   if (newValue)
     listbox->exflags |= GLF_NOBORDER;
-  guis_need_update = 1;
+  listbox->MarkChanged();
 }
 
 int ListBox_GetHideScrollArrows(GUIListBox *listbox) {
@@ -240,7 +242,7 @@ void ListBox_SetHideScrollArrows(GUIListBox *listbox, int newValue) {
   listbox->exflags &= ~GLF_NOARROWS;
   if (newValue)
     listbox->exflags |= GLF_NOARROWS;
-  guis_need_update = 1;
+  listbox->MarkChanged();
 }
 
 int ListBox_GetSelectedIndex(GUIListBox *listbox) {
@@ -262,7 +264,7 @@ void ListBox_SetSelectedIndex(GUIListBox *guisl, int newsel) {
       if (newsel >= guisl->topItem + guisl->num_items_fit)
         guisl->topItem = (newsel - guisl->num_items_fit) + 1;
     }
-    guis_need_update = 1;
+    guisl->MarkChanged();
   }
 
 }
@@ -278,7 +280,7 @@ void ListBox_SetTopItem(GUIListBox *guisl, int item) {
     quit("!ListBoxSetTopItem: tried to set top to beyond top or bottom of list");
 
   guisl->topItem = item;
-  guis_need_update = 1;
+  guisl->MarkChanged();
 }
 
 int ListBox_GetRowCount(GUIListBox *listbox) {
@@ -288,14 +290,14 @@ int ListBox_GetRowCount(GUIListBox *listbox) {
 void ListBox_ScrollDown(GUIListBox *listbox) {
   if (listbox->topItem + listbox->num_items_fit < listbox->numItems) {
     listbox->topItem++;
-    guis_need_update = 1;
+    listbox->MarkChanged();
   }
 }
 
 void ListBox_ScrollUp(GUIListBox *listbox) {
   if (listbox->topItem > 0) {
     listbox->topItem--;
-    guis_need_update = 1;
+    listbox->MarkChanged();
   }
 }
 
@@ -305,8 +307,9 @@ GUIListBox* is_valid_listbox (int guin, int objn) {
   if ((objn<0) | (objn>=guis[guin].numobjs)) quit("!ListBox: invalid object number");
   if (guis[guin].get_control_type(objn)!=GOBJ_LISTBOX)
     quit("!ListBox: specified control is not a list box");
-  guis_need_update = 1;
-  return (GUIListBox*)guis[guin].objs[objn];
+  GUIListBox *listbox = (GUIListBox*)guis[guin].objs[objn];
+  listbox->MarkChanged();
+  return listbox;
 }
 
 //=============================================================================
@@ -50,6 +50,7 @@
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
 #include "debug/out.h"
+#include "debug/tracer.h"
 #include "media/audio/audio.h"
 #include "platform/base/agsplatformdriver.h"
 #include "plugin/agsplugin.h"
@@ -396,6 +397,8 @@ extern int convert_16bit_bgr;
 // forchar = playerchar on NewRoom, or NULL if restore saved game
 void load_new_room(int newnum, CharacterInfo*forchar) {
 
+    TraceScope trace("room", "load_new_room", "room", newnum);
+
     DEBUG_CONSOLE("Loading room %d", newnum);
 
     String room_filename;
@@ -0,0 +1,97 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Direct access to the room masks (walkable areas, hotspots, regions).
+//
+// Room masks are 8-bit linear memory bitmaps, so their values may be read
+// straight from the scan lines instead of going through Bitmap::GetPixel and
+// Allegro's vtable. The functions work on the mask bitmaps themselves, so
+// whatever changes scripts or drawing surfaces make are seen immediately.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__ROOMMASK_H
+#define __AGS_EE_AC__ROOMMASK_H
+
+#include <math.h>
+#include <string.h>
+#include "gfx/bitmap.h"
+
+// Gets the mask value at the given mask coordinates, or -1 if the point is
+// outside of the mask, same as Bitmap::GetPixel does
+inline int get_mask_pixel(const AGS::Common::Bitmap *mask, int x, int y)
+{
+    if ((x < 0) || (y < 0) || (x >= mask->GetWidth()) || (y >= mask->GetHeight()))
+        return -1;
+    return mask->GetScanLine(y)[x];
+}
+
+// Sets mask values in the rectangle x1,y1 - x2,y2 inclusive, clipped to the mask
+inline void fill_mask_rect(AGS::Common::Bitmap *mask, int x1, int y1, int x2, int y2, int value)
+{
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= mask->GetWidth()) x2 = mask->GetWidth() - 1;
+    if (y2 >= mask->GetHeight()) y2 = mask->GetHeight() - 1;
+    if ((x1 > x2) || (y1 > y2))
+        return;
+    for (int y = y1; y <= y2; y++)
+        memset(mask->GetScanLineForWriting(y) + x1, value, x2 - x1 + 1);
+}
+
+// Gets the mask values of the given line, or NULL if it is outside of the mask
+inline const uint8_t *get_mask_row(const AGS::Common::Bitmap *mask, int y)
+{
+    if ((y < 0) || (y >= mask->GetHeight()))
+        return NULL;
+    return mask->GetScanLine(y);
+}
+
+// Finds the point nearest to dest_x,dest_y among every step-th point of the
+// rectangle x1,y1 - x2,y2 (x2 and y2 exclusive) which has the given mask
+// value, or any non-zero value if value is negative. Distances are compared
+// in whole pixels; of the equally near points the one with the least x, then
+// the least y is taken, as if the rectangle was searched column by column.
+// Returns false if no point matches.
+inline bool find_nearest_mask_point(const AGS::Common::Bitmap *mask, int x1, int y1, int x2, int y2,
+                                    int step, int value, int dest_x, int dest_y, int &found_x, int &found_y)
+{
+    if (x2 > mask->GetWidth()) x2 = mask->GetWidth();
+    if (y2 > mask->GetHeight()) y2 = mask->GetHeight();
+    bool found = false;
+    int nearest = 0;
+    for (int y = y1; y < y2; y += step)
+    {
+        if (y < 0)
+            continue;
+        const uint8_t *row = mask->GetScanLine(y);
+        for (int x = x1; x < x2; x += step)
+        {
+            if (x < 0)
+                continue;
+            if ((value >= 0) ? (row[x] != value) : (row[x] == 0))
+                continue;
+            const int distance = (int)sqrt((double)((x - dest_x) * (x - dest_x) + (y - dest_y) * (y - dest_y)));
+            if (!found || (distance < nearest) || ((distance == nearest) && (x < found_x)))
+            {
+                found = true;
+                nearest = distance;
+                found_x = x;
+                found_y = y;
+            }
+        }
+    }
+    return found;
+}
+
+#endif // __AGS_EE_AC__ROOMMASK_H
@@ -19,11 +19,15 @@
 
 #include "ac/route_finder.h"
 #include "ac/common.h"   // quit()
+#include "ac/gamesetup.h"
 #include "ac/movelist.h"     // MoveList
 #include "ac/point.h"
+#include "ac/roommask.h"
 #include "ac/common_defines.h"
 #include <string.h>
 #include <math.h>
+#include <algorithm>
+#include <vector>
 #include "gfx/bitmap.h"
 
 using AGS::Common::Bitmap;
@@ -37,10 +41,14 @@ int waspossible = 1;
 int suggestx, suggesty;
 fixed move_speed_x, move_speed_y;
 
+#define MAX_GRANULARITY 3
+int walk_area_granularity[MAX_WALK_AREAS + 1];
+
 extern void Display(char *, ...);
 extern void write_log(char *);
 extern void update_polled_stuff_if_runtime();
 
+extern GameSetup usetup;
 extern MoveList *mls;
 extern "C"
 {
@@ -51,6 +59,8 @@ void init_pathfinder()
 {
   pathbackx = (int *)malloc(sizeof(int) * MAXPATHBACK);
   pathbacky = (int *)malloc(sizeof(int) * MAXPATHBACK);
+  for (int i = 0; i <= MAX_WALK_AREAS; i++)
+    walk_area_granularity[i] = MAX_GRANULARITY;
 }
 
 Bitmap *wallscreen;
@@ -59,18 +69,6 @@ char *movelibcopyright = "PathFinder library v3.1 (c) 1998, 1999, 2001, 2002 Chr
 int line_failed = 0;
 int lastcx, lastcy;
 
-// TODO: find a way to reimpl this with Bitmap
-void line_callback(BITMAP *bmpp, int x, int y, int d)
-{
-/*  if ((x>=320) | (y>=200) | (x<0) | (y<0)) line_failed=1;
-  else */ if (getpixel(bmpp, x, y) < 1)
-    line_failed = 1;
-  else if (line_failed == 0) {
-    lastcx = x;
-    lastcy = y;
-  }
-}
-
 // check the copyright message is intact
 #ifdef _MSC_VER
 extern void winalert(char *, ...);
@@ -85,40 +83,50 @@ int can_see_from(int x1, int y1, int x2, int y2)
   if ((x1 == x2) && (y1 == y2))
     return 1;
 
-  // TODO: need some way to use Bitmap with callback
-  do_line((BITMAP*)wallscreen->GetAllegroBitmap(), x1, y1, x2, y2, 0, line_callback);
-  if (line_failed == 0)
-    return 1;
+  // Walk the line visiting same pixels as Allegro's do_line would, but
+  // stop at the first non-walkable one
+  int dx = abs(x2 - x1), dy = abs(y2 - y1);
+  const int stepx = (x2 >= x1) ? 1 : -1;
+  const int stepy = (y2 >= y1) ? 1 : -1;
+  const bool along_x = dx >= dy;
+  const int main_len = along_x ? dx : dy;
+  const int side_len = along_x ? dy : dx;
+  int err = 2 * side_len - main_len;
+  int x = x1, y = y1;
+  for (int i = 0; i <= main_len; i++) {
+    if (get_mask_pixel(wallscreen, x, y) < 1) {
+      line_failed = 1;
+      return 0;
+    }
+    lastcx = x;
+    lastcy = y;
 
-  return 0;
+    if (err >= 0) {
+      if (along_x)
+        y += stepy;
+      else
+        x += stepx;
+      err += 2 * (side_len - main_len);
+    }
+    else
+      err += 2 * side_len;
+    if (along_x)
+      x += stepx;
+    else
+      y += stepy;
+  }
+  return 1;
 }
 
 int find_nearest_walkable_area(Bitmap *tempw, int fromX, int fromY, int toX, int toY, int destX, int destY, int granularity)
 {
-  int ex, ey, nearest = 99999, thisis, nearx, neary;
+  int nearx, neary;
   if (fromX < 0) fromX = 0;
   if (fromY < 0) fromY = 0;
   if (toX >= tempw->GetWidth()) toX = tempw->GetWidth() - 1;
   if (toY >= tempw->GetHeight()) toY = tempw->GetHeight() - 1;
 
-  for (ex = fromX; ex < toX; ex += granularity) 
-  {
-    for (ey = fromY; ey < toY; ey += granularity) 
-    {
-      if (tempw->GetScanLine(ey)[ex] != 232)
-        continue;
-
-      thisis = (int)::sqrt((double)((ex - destX) * (ex - destX) + (ey - destY) * (ey - destY)));
-      if (thisis < nearest)
-      {
-        nearest = thisis;
-        nearx = ex;
-        neary = ey;
-      }
-    }
-  }
-
-  if (nearest < 90000) {
+  if (find_nearest_mask_point(tempw, fromX, fromY, toX, toY, granularity, 232, destX, destY, nearx, neary)) {
     suggestx = nearx;
     suggesty = neary;
     return 1;
@@ -127,26 +135,33 @@ int find_nearest_walkable_area(Bitmap *tempw, int fromX, int fromY, int toX, int
   return 0;
 }
 
-#define MAX_GRANULARITY 3
-int walk_area_granularity[MAX_WALK_AREAS + 1];
-int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
-{
-  wallscreen = wss;
-  suggestx = -1;
+// Memory taken by the working buffers of the current route search, and the
+// most any search has taken since it was last reported
+size_t route_search_memory = 0;
+size_t route_peak_memory = 0;
 
-  // ensure it's a memory bitmap, so we can use direct access to line[] array
-  if ((wss == NULL) || (!wss->IsMemoryBitmap()) || (wss->GetColorDepth() != 8))
-    quit("is_route_possible: invalid walkable areas bitmap supplied");
+void add_route_search_memory(size_t bytes)
+{
+  route_search_memory += bytes;
+  if (route_search_memory > route_peak_memory)
+    route_peak_memory = route_search_memory;
+}
 
-  if (wallscreen->GetPixel(fromx, fromy) < 1)
-    return 0;
+size_t get_route_finder_peak_memory()
+{
+  const size_t peak = route_peak_memory;
+  route_peak_memory = 0;
+  return peak;
+}
 
-  Bitmap *tempw = BitmapHelper::CreateBitmapCopy(wallscreen, 8);
+// Reused between the route calculations
+Bitmap *route_fill_bitmap = NULL;
 
-  if (tempw == NULL)
-    quit("no memory for route calculation");
-  if (!tempw->IsMemoryBitmap())
-    quit("tempw is not memory bitmap");
+void calculate_walk_area_granularity(Bitmap *walkable_areas)
+{
+  // ensure it's a memory bitmap, so we can use direct access to line[] array
+  if ((walkable_areas == NULL) || (!walkable_areas->IsMemoryBitmap()) || (walkable_areas->GetColorDepth() != 8))
+    quit("calculate_walk_area_granularity: invalid walkable areas bitmap supplied");
 
   int dd, ff;
   // initialize array for finding widths of walkable areas
@@ -157,10 +172,10 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
     walk_area_granularity[dd] = 0;
   }
 
-  for (ff = 0; ff < tempw->GetHeight(); ff++) {
-    const uint8_t *tempw_scanline = tempw->GetScanLine(ff);
-    for (dd = 0; dd < tempw->GetWidth(); dd++) {
-      thisar = tempw_scanline[dd];
+  for (ff = 0; ff < walkable_areas->GetHeight(); ff++) {
+    const uint8_t *walls_scanline = walkable_areas->GetScanLine(ff);
+    for (dd = 0; dd < walkable_areas->GetWidth(); dd++) {
+      thisar = walls_scanline[dd];
       // count how high the area is at this point
       if ((thisar == lastarea) && (thisar > 0))
         inarow++;
@@ -175,12 +190,9 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
     }
   }
 
-  for (dd = 0; dd < tempw->GetWidth(); dd++) {
-    for (ff = 0; ff < tempw->GetHeight(); ff++) {
-      uint8_t *tempw_scanline = tempw->GetScanLineForWriting(ff);
-      thisar = tempw_scanline[dd];
-      if (thisar > 0)
-        tempw_scanline[dd] = 1;
+  for (dd = 0; dd < walkable_areas->GetWidth(); dd++) {
+    for (ff = 0; ff < walkable_areas->GetHeight(); ff++) {
+      thisar = walkable_areas->GetScanLine(ff)[dd];
       // count how high the area is at this point
       if ((thisar == lastarea) && (thisar > 0))
         inarow++;
@@ -213,6 +225,107 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
        winalert(toprnt); */
   }
   walk_area_granularity[0] = MAX_GRANULARITY;
+}
+
+// Route finding data of the current room: the step sizes worked out for the
+// few most recent sets of solid characters and objects cut out of the mask
+#define MAX_ROOM_BLOCKER_SETS 8
+struct RouteBlockerSet
+{
+  std::vector<int> Rects;
+  int Granularity[MAX_WALK_AREAS + 1];
+};
+std::vector<RouteBlockerSet> room_blocker_sets;
+// The mask which the blockers below were last cut out of
+Bitmap *room_blocked_mask = NULL;
+std::vector<int> room_blocker_rects;
+
+void reset_room_route_data()
+{
+  room_blocker_sets.clear();
+  room_blocked_mask = NULL;
+  room_blocker_rects.clear();
+}
+
+void build_room_route_data(Bitmap *walkable_areas)
+{
+  reset_room_route_data();
+  // the mask without blockers is the most common one
+  calculate_walk_area_granularity(walkable_areas);
+  room_blocker_sets.push_back(RouteBlockerSet());
+  memcpy(room_blocker_sets.back().Granularity, walk_area_granularity, sizeof(walk_area_granularity));
+}
+
+void begin_route_blockers(Bitmap *mask)
+{
+  room_blocked_mask = mask;
+  room_blocker_rects.clear();
+}
+
+void add_route_blocker(int x1, int y1, int x2, int y2)
+{
+  room_blocker_rects.push_back(x1);
+  room_blocker_rects.push_back(y1);
+  room_blocker_rects.push_back(x2);
+  room_blocker_rects.push_back(y2);
+}
+
+void set_walk_area_granularity(Bitmap *wss)
+{
+  // The step sizes are worked out from the searched mask itself, unless it
+  // is the room's mask with a set of blockers seen before
+  if ((wss != room_blocked_mask) || room_blocker_sets.empty()) {
+    calculate_walk_area_granularity(wss);
+    return;
+  }
+  for (size_t i = 0; i < room_blocker_sets.size(); i++) {
+    if (room_blocker_sets[i].Rects == room_blocker_rects) {
+      memcpy(walk_area_granularity, room_blocker_sets[i].Granularity, sizeof(walk_area_granularity));
+      return;
+    }
+  }
+  calculate_walk_area_granularity(wss);
+  // forget the oldest set, but keep the one without blockers
+  if (room_blocker_sets.size() >= MAX_ROOM_BLOCKER_SETS)
+    room_blocker_sets.erase(room_blocker_sets.begin() + 1);
+  room_blocker_sets.push_back(RouteBlockerSet());
+  room_blocker_sets.back().Rects = room_blocker_rects;
+  memcpy(room_blocker_sets.back().Granularity, walk_area_granularity, sizeof(walk_area_granularity));
+}
+
+int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
+{
+  wallscreen = wss;
+  suggestx = -1;
+
+  // ensure it's a memory bitmap, so we can use direct access to line[] array
+  if ((wss == NULL) || (!wss->IsMemoryBitmap()) || (wss->GetColorDepth() != 8))
+    quit("is_route_possible: invalid walkable areas bitmap supplied");
+
+  if (get_mask_pixel(wallscreen, fromx, fromy) < 1)
+    return 0;
+
+  set_walk_area_granularity(wss);
+
+  if ((route_fill_bitmap == NULL) || (route_fill_bitmap->GetWidth() != wss->GetWidth()) ||
+      (route_fill_bitmap->GetHeight() != wss->GetHeight())) {
+    delete route_fill_bitmap;
+    route_fill_bitmap = BitmapHelper::CreateBitmap(wss->GetWidth(), wss->GetHeight(), 8);
+    if (route_fill_bitmap == NULL)
+      quit("no memory for route calculation");
+    if (!route_fill_bitmap->IsMemoryBitmap())
+      quit("tempw is not memory bitmap");
+  }
+  Bitmap *tempw = route_fill_bitmap;
+  add_route_search_memory(tempw->GetWidth() * tempw->GetHeight());
+
+  // make all the walkable areas same colour, so that they are filled together
+  for (int ff = 0; ff < tempw->GetHeight(); ff++) {
+    const uint8_t *wss_scanline = wss->GetScanLine(ff);
+    uint8_t *tempw_scanline = tempw->GetScanLineForWriting(ff);
+    for (int dd = 0; dd < tempw->GetWidth(); dd++)
+      tempw_scanline[dd] = (wss_scanline[dd] > 0) ? 1 : 0;
+  }
 
   tempw->FloodFill(fromx, fromy, 232);
   if (tempw->GetPixel(tox, toy) != 232) 
@@ -227,12 +340,8 @@ int is_route_possible(int fromx, int fromy, int tox, int toy, Bitmap *wss)
       // Nothing found, sweep the whole room at 5 pixel granularity
       find_nearest_walkable_area(tempw, 0, 0, tempw->GetWidth(), tempw->GetHeight(), tox, toy, 5);
     }
-
-    delete tempw;
     return 0;
   }
-  delete tempw;
-
   return 1;
 }
 
@@ -305,7 +414,7 @@ try_again:
   }
 
   if (((nextx < 0) | (nextx >= wallscreen->GetWidth()) | (nexty < 0) | (nexty >= wallscreen->GetHeight())) ||
-      (wallscreen->GetPixel(nextx, nexty) == 0) || ((beenhere[srcy][srcx] & (1 << trydir)) != 0)) {
+      (get_mask_pixel(wallscreen, nextx, nexty) == 0) || ((beenhere[srcy][srcx] & (1 << trydir)) != 0)) {
 
     if (leftorright == 0) {
       trydir++;
@@ -362,7 +471,7 @@ try_again:
 // and move a bit if this causes them to become non-walkable
 void round_down_coords(int &tmpx, int &tmpy)
 {
-  int startgran = walk_area_granularity[wallscreen->GetPixel(tmpx, tmpy)];
+  int startgran = walk_area_granularity[get_mask_pixel(wallscreen, tmpx, tmpy)];
   tmpy = tmpy - tmpy % startgran;
 
   if (tmpy < 0)
@@ -372,12 +481,12 @@ void round_down_coords(int &tmpx, int &tmpy)
   if (tmpx < 0)
     tmpx = 0;
 
-  if (wallscreen->GetPixel(tmpx, tmpy) == 0) {
+  if (get_mask_pixel(wallscreen, tmpx, tmpy) == 0) {
     tmpx += startgran;
-    if ((wallscreen->GetPixel(tmpx, tmpy) == 0) && (tmpy < wallscreen->GetHeight() - startgran)) {
+    if ((get_mask_pixel(wallscreen, tmpx, tmpy) == 0) && (tmpy < wallscreen->GetHeight() - startgran)) {
       tmpy += startgran;
 
-      if (wallscreen->GetPixel(tmpx, tmpy) == 0)
+      if (get_mask_pixel(wallscreen, tmpx, tmpy) == 0)
         tmpx -= startgran;
     }
   }
@@ -409,6 +518,7 @@ int find_route_dijkstra(int fromx, int fromy, int destx, int desty)
   int *parent = (int *)malloc(allocsize);
   int min = 999999, cheapest[40], newcell[40], replace[40];
   int *visited = (int *)malloc(MAX_TRAIL_LENGTH * sizeof(int));
+  add_route_search_memory(allocsize + MAX_TRAIL_LENGTH * sizeof(int));
   int iteration = 1;
   visited[0] = fromy * wallscreen->GetWidth() + fromx;
   parent[visited[0]] = -1;
@@ -565,9 +675,208 @@ int find_route_dijkstra(int fromx, int fromy, int destx, int desty)
   return 1;
 }
 
+// A* search over the walkable areas mask. Each step is as long as the
+// granularity of the area it starts from, same as in find_route_dijkstra,
+// but the steps may go diagonally as well.
+const int ASTAR_STRAIGHT_COST = 10;
+const int ASTAR_DIAGONAL_COST = 14;
+const int astar_dirx[8] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+const int astar_diry[8] = { 0, -1, 0, 1, -1, -1, 1, 1 };
+
+struct AStarNode
+{
+  int estimate; // path cost plus the heuristic
+  int cost;
+  int index;
+
+  // the heap keeps the cheapest estimate on top; on ties prefer the nodes
+  // which went further, as they are likely closer to the destination
+  bool operator <(const AStarNode &other) const
+  {
+    if (estimate != other.estimate)
+      return estimate > other.estimate;
+    return cost < other.cost;
+  }
+};
+
+int *astar_parent = NULL;
+int *astar_cost = NULL;
+// number of the search which last reached the node; lets reuse the node
+// buffers without clearing them for every search
+unsigned int *astar_search = NULL;
+int astar_buffer_size = 0;
+unsigned int astar_search_id = 0;
+std::vector<AStarNode> astar_open;
+
+// Edges of screen pose a problem, so if the point and destination are
+// within certain distance of the edge, treat them as aligned
+inline void astar_snap_to_edge(int &x, int &y, int destx, int desty)
+{
+  if ((x >= wallscreen->GetWidth() - MAX_GRANULARITY) && (destx >= wallscreen->GetWidth() - MAX_GRANULARITY))
+    x = destx;
+  if ((y >= wallscreen->GetHeight() - MAX_GRANULARITY) && (desty >= wallscreen->GetHeight() - MAX_GRANULARITY))
+    y = desty;
+}
+
+inline bool is_astar_goal(int x, int y, int destx, int desty)
+{
+  astar_snap_to_edge(x, y, destx, desty);
+  return (abs(x - destx) <= MAX_GRANULARITY) && (abs(y - desty) <= MAX_GRANULARITY);
+}
+
+// Octile distance to the destination area
+inline int astar_heuristic(int x, int y, int destx, int desty)
+{
+  astar_snap_to_edge(x, y, destx, desty);
+  int dx = abs(x - destx) - MAX_GRANULARITY;
+  int dy = abs(y - desty) - MAX_GRANULARITY;
+  if (dx < 0) dx = 0;
+  if (dy < 0) dy = 0;
+  if (dx < dy)
+    std::swap(dx, dy);
+  return ASTAR_STRAIGHT_COST * dx + (ASTAR_DIAGONAL_COST - ASTAR_STRAIGHT_COST) * dy;
+}
+
+inline int sign(int value)
+{
+  return (value > 0) - (value < 0);
+}
+
+// Tells if the path goes straight through the middle node
+inline bool is_astar_straight(int prev, int mid, int next, int width)
+{
+  return (sign(mid % width - prev % width) == sign(next % width - mid % width)) &&
+    (sign(mid / width - prev / width) == sign(next / width - mid / width));
+}
+
+int find_route_astar(int fromx, int fromy, int destx, int desty)
+{
+  // This algorithm doesn't behave differently the second time, so ignore
+  if (leftorright == 1)
+    return 0;
+
+  const int width = wallscreen->GetWidth();
+  const int height = wallscreen->GetHeight();
+  if (width * height > astar_buffer_size)
+  {
+    astar_buffer_size = width * height;
+    astar_parent = (int *)realloc(astar_parent, astar_buffer_size * sizeof(int));
+    astar_cost = (int *)realloc(astar_cost, astar_buffer_size * sizeof(int));
+    astar_search = (unsigned int *)realloc(astar_search, astar_buffer_size * sizeof(unsigned int));
+    if ((astar_parent == NULL) || (astar_cost == NULL) || (astar_search == NULL))
+      quit("insufficient memory to allocate pathfinder buffers");
+    memset(astar_search, 0, astar_buffer_size * sizeof(unsigned int));
+    astar_search_id = 0;
+  }
+  if (++astar_search_id == 0)
+  {
+    memset(astar_search, 0, astar_buffer_size * sizeof(unsigned int));
+    astar_search_id = 1;
+  }
+
+  round_down_coords(fromx, fromy);
+  int temprd = destx, tempry = desty;
+  round_down_coords(temprd, tempry);
+  if ((temprd == fromx) && (tempry == fromy)) {
+    // already at destination
+    pathbackstage = 0;
+    return 1;
+  }
+
+  update_polled_stuff_if_runtime();
+
+  const int start = fromy * width + fromx;
+  astar_search[start] = astar_search_id;
+  astar_cost[start] = 0;
+  astar_parent[start] = -1;
+  astar_open.clear();
+  AStarNode start_node = { astar_heuristic(fromx, fromy, destx, desty), 0, start };
+  astar_open.push_back(start_node);
+
+  int found = -1, expanded = 0;
+  while (!astar_open.empty()) {
+    const AStarNode node = astar_open.front();
+    std::pop_heap(astar_open.begin(), astar_open.end());
+    astar_open.pop_back();
+    // the node was reached by a cheaper path after this entry was added
+    if (node.cost > astar_cost[node.index])
+      continue;
+
+    const int x = node.index % width;
+    const int y = node.index / width;
+    if (is_astar_goal(x, y, destx, desty)) {
+      found = node.index;
+      break;
+    }
+
+    if (++expanded % 1000 == 0)
+      update_polled_stuff_if_runtime();
+
+    const uint8_t *scanline = wallscreen->GetScanLine(y);
+    const int granularity = walk_area_granularity[scanline[x]];
+    for (int dir = 0; dir < 8; dir++) {
+      const int nextx = x + astar_dirx[dir] * granularity;
+      const int nexty = y + astar_diry[dir] * granularity;
+      if ((nextx < 0) || (nextx >= width) || (nexty < 0) || (nexty >= height))
+        continue;
+      const uint8_t *next_scanline = wallscreen->GetScanLine(nexty);
+      if (next_scanline[nextx] == 0)
+        continue;
+
+      int cost = node.cost;
+      if ((astar_dirx[dir] != 0) && (astar_diry[dir] != 0)) {
+        // don't cut the corners of non-walkable areas
+        if ((scanline[nextx] == 0) || (next_scanline[x] == 0))
+          continue;
+        cost += ASTAR_DIAGONAL_COST * granularity;
+      }
+      else
+        cost += ASTAR_STRAIGHT_COST * granularity;
+
+      const int next = nexty * width + nextx;
+      if ((astar_search[next] == astar_search_id) && (astar_cost[next] <= cost))
+        continue;
+      astar_search[next] = astar_search_id;
+      astar_cost[next] = cost;
+      astar_parent[next] = node.index;
+      AStarNode next_node = { cost + astar_heuristic(nextx, nexty, destx, desty), cost, next };
+      astar_open.push_back(next_node);
+      std::push_heap(astar_open.begin(), astar_open.end());
+    }
+  }
+
+  add_route_search_memory(width * height * (sizeof(*astar_parent) + sizeof(*astar_cost) + sizeof(*astar_search)) +
+    astar_open.capacity() * sizeof(AStarNode));
+  if (found < 0)
+    return 0;
+
+  // Path is stored backwards, starting from the destination; if it does not
+  // fit into the path buffer then keep only the points where it turns
+  int length = 0;
+  for (int on = astar_parent[found]; on >= 0; on = astar_parent[on])
+    length++;
+  const bool turns_only = length >= MAXPATHBACK - 1;
+
+  pathbackstage = 0;
+  pathbackx[pathbackstage] = destx;
+  pathbacky[pathbackstage] = desty;
+  pathbackstage++;
+
+  for (int prev = found, on = astar_parent[found]; on >= 0; prev = on, on = astar_parent[on]) {
+    if (turns_only && (astar_parent[on] >= 0) && is_astar_straight(prev, on, astar_parent[on], width))
+      continue;
+    if (pathbackstage >= MAXPATHBACK)
+      return 0;
+    pathbackx[pathbackstage] = on % width;
+    pathbacky[pathbackstage] = on / width;
+    pathbackstage++;
+  }
+  return 1;
+}
+
 int __find_route(int srcx, int srcy, short *tox, short *toy, int noredx)
 {
-  if ((noredx == 0) && (wallscreen->GetPixel(tox[0], toy[0]) == 0))
+  if ((noredx == 0) && (get_mask_pixel(wallscreen, tox[0], toy[0]) == 0))
     return 0; // clicked on a wall
 
   int is_straight = 0;
@@ -602,6 +911,10 @@ findroutebk:
 
   if (is_straight)
     ;            // don't use new algo on arrow key presses
+  else if (usetup.pathfinder == kPathfinder_AStar) {
+    if (find_route_astar(srcx, srcy, tox[0], toy[0]))
+      return 1;
+  }
   else if (find_route_dijkstra(srcx, srcy, tox[0], toy[0])) {
     return 1;
   }
@@ -726,6 +1039,7 @@ int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int
 #endif
   wallscreen = onscreen;
   leftorright = 0;
+  route_search_memory = 0;
   int aaa;
 
   if (wallscreen->GetHeight() > beenhere_array_size)
@@ -748,6 +1062,7 @@ int find_route(short srcx, short srcy, short xx, short yy, Bitmap *onscreen, int
   }
   else {
     beenhere[0] = (short *)malloc((wallscreen->GetWidth()) * (wallscreen->GetHeight()) * BEENHERE_SIZE);
+    add_route_search_memory((wallscreen->GetWidth()) * (wallscreen->GetHeight()) * BEENHERE_SIZE);
 
     for (aaa = 1; aaa < wallscreen->GetHeight(); aaa++)
       beenhere[aaa] = beenhere[0] + aaa * (wallscreen->GetWidth());
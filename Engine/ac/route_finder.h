@@ -21,7 +21,20 @@ void calculate_move_stage(MoveList * mlsp, int aaa);
 int can_see_from(int x1, int y1, int x2, int y2);
 
 void init_pathfinder();
+// Works out the route finding data of the room's walkable areas; must be
+// called again whenever they change
+void build_room_route_data(Common::Bitmap *walkable_areas);
+// Forgets the route finding data, which is then worked out on every query
+// until the room's data is built again
+void reset_room_route_data();
+// Records the solid characters and objects cut out of the room's mask
+// before searching it for a route
+void begin_route_blockers(Common::Bitmap *mask);
+void add_route_blocker(int x1, int y1, int x2, int y2);
 void set_route_move_speed(int speed_x, int speed_y);
+// Gets the most memory the working buffers of a single route search have
+// taken since the last call, in bytes
+size_t get_route_finder_peak_memory();
 int find_route(short srcx, short srcy, short xx, short yy, Common::Bitmap *onscreen, int movlst, int nocross =
                0, int ignore_walls = 0);
 
@@ -0,0 +1,179 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <map>
+#include <string.h>
+#include "util/wgt2allg.h"
+#include "ac/savegameindex.h"
+#include "debug/out.h"
+#include "util/file.h"
+#include "util/stream.h"
+
+using AGS::Common::Stream;
+using AGS::Common::String;
+namespace Out = AGS::Common::Out;
+
+extern char saveGameDirectory[260];
+
+// Index file format version; the index is simply rebuilt when it does
+// not match
+const int SavegameIndexVersion = 2;
+const char *SavegameIndexSig = "AGSSaveIndex";
+// Limits, past which the index file is considered corrupt
+const int MaxIndexedSavegames = 100000;
+const int MaxIndexedStringLength = 1000;
+
+struct SavegameIndexEntry
+{
+    int64_t      FileTime;
+    int64_t      FileSize;
+    SavegameInfo Info;
+};
+
+typedef std::map<String, SavegameIndexEntry> SavegameIndex;
+
+SavegameIndex savegame_index;
+String        savegame_index_dir;           // save directory the index was loaded for
+bool          savegame_index_loaded = false;
+bool          savegame_index_changed = false;
+
+String get_savegame_index_path()
+{
+    return String::FromFormat("%s""savegames.idx", savegame_index_dir.GetCStr());
+}
+
+void load_savegame_index()
+{
+    savegame_index.clear();
+    savegame_index_changed = false;
+    Stream *in = Common::File::OpenFileRead(get_savegame_index_path());
+    if (!in)
+        return;
+
+    String sig = String::FromStreamCount(in, strlen(SavegameIndexSig));
+    int count = 0;
+    if (sig.Compare(SavegameIndexSig) == 0 && in->ReadInt32() == SavegameIndexVersion)
+        count = in->ReadInt32();
+    if (count < 0 || count > MaxIndexedSavegames)
+        count = 0;
+    for (int i = 0; i < count && !in->EOS(); ++i)
+    {
+        String name = String::FromStream(in, MaxIndexedStringLength);
+        SavegameIndexEntry entry;
+        entry.FileTime = in->ReadInt64();
+        entry.FileSize = in->ReadInt64();
+        entry.Info.Description = String::FromStream(in, MaxIndexedStringLength);
+        entry.Info.ThumbnailOffset = in->ReadInt32();
+        entry.Info.ThumbnailSize = in->ReadInt32();
+        entry.Info.HasScreenshot = in->ReadInt8();
+        savegame_index[name] = entry;
+    }
+    if (in->EOS() && (int)savegame_index.size() < count)
+    {
+        // Truncated file, do not trust any of it
+        savegame_index.clear();
+    }
+    delete in;
+}
+
+void save_savegame_index()
+{
+    Stream *out = Common::File::CreateFile(get_savegame_index_path());
+    if (!out)
+    {
+        Out::FPrint("Unable to write saved games index to '%s'", get_savegame_index_path().GetCStr());
+        return;
+    }
+    out->Write(SavegameIndexSig, strlen(SavegameIndexSig));
+    out->WriteInt32(SavegameIndexVersion);
+    out->WriteInt32(savegame_index.size());
+    for (SavegameIndex::const_iterator it = savegame_index.begin(); it != savegame_index.end(); ++it)
+    {
+        it->first.Write(out);
+        out->WriteInt64(it->second.FileTime);
+        out->WriteInt64(it->second.FileSize);
+        it->second.Info.Description.Write(out);
+        out->WriteInt32(it->second.Info.ThumbnailOffset);
+        out->WriteInt32(it->second.Info.ThumbnailSize);
+        out->WriteInt8(it->second.Info.HasScreenshot);
+    }
+    delete out;
+}
+
+// Makes sure the index of the current save directory is loaded, and gets
+// the file name the saved game is indexed by; returns false if the saved
+// game is not in the save directory
+bool get_savegame_index_name(const String &path, String &name)
+{
+    if (!savegame_index_loaded || savegame_index_dir.Compare(saveGameDirectory) != 0)
+    {
+        update_savegame_index();
+        savegame_index_dir = saveGameDirectory;
+        load_savegame_index();
+        savegame_index_loaded = true;
+    }
+    const int dir_length = savegame_index_dir.GetLength();
+    if (path.GetLength() <= dir_length || path.CompareLeft(savegame_index_dir, dir_length) != 0)
+        return false;
+    name = path.Mid(dir_length);
+    return true;
+}
+
+bool get_indexed_savegame_info(const String &path, SavegameInfo &info)
+{
+    String name;
+    if (!get_savegame_index_name(path, name))
+        return false;
+    SavegameIndex::iterator it = savegame_index.find(name);
+    if (it == savegame_index.end())
+        return false;
+    if (it->second.FileTime != (int64_t)file_time(path) ||
+        it->second.FileSize != (int64_t)file_size_ex(path))
+    {
+        savegame_index.erase(it);
+        savegame_index_changed = true;
+        return false;
+    }
+    info = it->second.Info;
+    return true;
+}
+
+void index_savegame_info(const String &path, const SavegameInfo &info)
+{
+    String name;
+    if (!get_savegame_index_name(path, name))
+        return;
+    SavegameIndexEntry entry;
+    entry.FileTime = file_time(path);
+    entry.FileSize = file_size_ex(path);
+    entry.Info = info;
+    savegame_index[name] = entry;
+    savegame_index_changed = true;
+}
+
+void forget_savegame_info(const String &path)
+{
+    String name;
+    if (get_savegame_index_name(path, name) && savegame_index.erase(name) > 0)
+        savegame_index_changed = true;
+}
+
+void update_savegame_index()
+{
+    if (savegame_index_changed)
+    {
+        save_savegame_index();
+        savegame_index_changed = false;
+    }
+}
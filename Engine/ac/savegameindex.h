@@ -0,0 +1,57 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Index of the saved games in the save directory.
+//
+// Listing the saved games needs the description of every one of them, which
+// means opening each file and parsing its head. The index file keeps the
+// descriptions and the thumbnail location of the saved games, along with the
+// time and size of every file when it was indexed; an entry is only used
+// while these still match the file, so that the saved games replaced by
+// other means than the engine are read again.
+//
+//=============================================================================
+#ifndef __AGS_EE_AC__SAVEGAMEINDEX_H
+#define __AGS_EE_AC__SAVEGAMEINDEX_H
+
+#include "util/string.h"
+
+using namespace AGS; // FIXME later
+
+struct SavegameInfo
+{
+    Common::String Description;
+    int            ThumbnailOffset; // rich media header's thumbnail, 0 if there is none
+    int            ThumbnailSize;
+    int            HasScreenshot;   // saved game's own screenshot: 1 or 0, or -1 if not known yet
+
+    SavegameInfo()
+        : ThumbnailOffset(0)
+        , ThumbnailSize(0)
+        , HasScreenshot(-1)
+    {
+    }
+};
+
+// Gets the information about the saved game from the index; returns false
+// if the file is not indexed or has changed since
+bool get_indexed_savegame_info(const Common::String &path, SavegameInfo &info);
+// Puts the information about the saved game file, as it is now, into the index
+void index_savegame_info(const Common::String &path, const SavegameInfo &info);
+// Removes the saved game from the index, before the file is written or deleted
+void forget_savegame_info(const Common::String &path);
+// Writes the index file, if the index was changed
+void update_savegame_index();
+
+#endif // __AGS_EE_AC__SAVEGAMEINDEX_H
@@ -15,7 +15,6 @@
 #include "ac/slider.h"
 #include "ac/common.h"
 
-extern int guis_need_update;
 
 // *** SLIDER FUNCTIONS
 
@@ -29,7 +28,7 @@ void Slider_SetMax(GUISlider *guisl, int valn) {
         if (guisl->min > guisl->max)
             quit("!Slider.Max: minimum cannot be greater than maximum");
 
-        guis_need_update = 1;
+        guisl->MarkChanged();
     }
 
 }
@@ -48,7 +47,7 @@ void Slider_SetMin(GUISlider *guisl, int valn) {
         if (guisl->min > guisl->max)
             quit("!Slider.Min: minimum cannot be greater than maximum");
 
-        guis_need_update = 1;
+        guisl->MarkChanged();
     }
 
 }
@@ -63,7 +62,7 @@ void Slider_SetValue(GUISlider *guisl, int valn) {
 
     if (valn != guisl->value) {
         guisl->value = valn;
-        guis_need_update = 1;
+        guisl->MarkChanged();
     }
 }
 
@@ -80,7 +79,7 @@ void Slider_SetBackgroundGraphic(GUISlider *guisl, int newImage)
     if (newImage != guisl->bgimage)
     {
         guisl->bgimage = newImage;
-        guis_need_update = 1;
+        guisl->MarkChanged();
     }
 }
 
@@ -93,7 +92,7 @@ void Slider_SetHandleGraphic(GUISlider *guisl, int newImage)
     if (newImage != guisl->handlepic)
     {
         guisl->handlepic = newImage;
-        guis_need_update = 1;
+        guisl->MarkChanged();
     }
 }
 
@@ -106,7 +105,7 @@ void Slider_SetHandleOffset(GUISlider *guisl, int newOffset)
     if (newOffset != guisl->handleoffset)
     {
         guisl->handleoffset = newOffset;
-        guis_need_update = 1;
+        guisl->MarkChanged();
     }
 }
 
@@ -20,6 +20,7 @@
 #include "platform/base/agsplatformdriver.h"
 #include "plugin/agsplugin.h"
 #include "ac/spritecache.h"
+#include "debug/tracer.h"
 #include "gfx/bitmap.h"
 #include "gfx/graphicsdriver.h"
 
@@ -132,6 +133,23 @@ void pre_save_sprite(int ee) {
     // not used, we don't save
 }
 
+// Sprite cache activity is recorded to the trace
+int64_t sprite_load_start = 0;
+void on_sprite_loading(int ee) {
+    if (Tracer::IsEnabled())
+        sprite_load_start = AGS::Engine::GetClockMicroseconds();
+}
+
+void on_sprite_loaded(int ee) {
+    if (Tracer::IsEnabled())
+        Tracer::AddEvent("sprites", "load_sprite", sprite_load_start,
+            AGS::Engine::GetClockMicroseconds() - sprite_load_start, "sprite", ee);
+}
+
+void on_sprite_evicted(int ee) {
+    Tracer::AddInstantEvent("sprites", "evict_sprite", "sprite", ee);
+}
+
 // these vars are global to help with debugging
 Bitmap *tmpdbl, *curspr;
 int newwid, newhit;
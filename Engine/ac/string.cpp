@@ -21,6 +21,7 @@
 #include "ac/runtime_defines.h"
 #include "ac/dynobj/scriptstring.h"
 #include "debug/debug_log.h"
+#include "font/textlayoutcache.h"
 #include "util/string_utils.h"
 #include "script/runtimescriptvalue.h"
 
@@ -305,6 +306,9 @@ void break_up_text_into_lines(int wii,int fonnt, const char*todis) {
     if (wii < 3)
         return;
 
+    if (get_cached_text_layout(todis, fonnt, wii))
+        return;
+
     int rr;
 
     if (game.options[OPT_RIGHTLEFTWRITE] == 0)
@@ -323,6 +327,8 @@ void break_up_text_into_lines(int wii,int fonnt, const char*todis) {
         if (wgettextwidth_compensate(lines[rr],fonnt) > longestline)
             longestline = wgettextwidth_compensate(lines[rr],fonnt);
     }
+
+    cache_text_layout(todis, fonnt, wii);
 }
 
 int MAXSTRLEN = MAX_MAXSTRLEN;
@@ -24,6 +24,7 @@
 #include "ac/dynobj/scriptsystem.h"
 #include "debug/debug_log.h"
 #include "main/main.h"
+#include "media/audio/audio.h"
 #include "media/audio/soundclip.h"
 #include "gfx/graphicsdriver.h"
 #include "ac/dynobj/cc_audiochannel.h"
@@ -173,6 +174,7 @@ void System_SetVolume(int newvol)
     {
         if ((channels[i] != NULL) && (channels[i]->done == 0)) 
         {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             channels[i]->set_volume(channels[i]->vol);
         }
     }
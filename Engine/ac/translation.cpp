@@ -22,6 +22,7 @@
 #include "ac/translation.h"
 #include "ac/tree_map.h"
 #include "debug/out.h"
+#include "font/textlayoutcache.h"
 #include "util/misc.h"
 #include "util/stream.h"
 #include "core/assetmanager.h"
@@ -45,6 +46,8 @@ void close_translation () {
         delete transtree;
         transtree = NULL;
     }
+    // Translation may have changed text direction
+    invalidate_text_layout_cache();
 }
 
 bool parse_translation(Stream *language_file, String &parse_error);
@@ -119,6 +122,7 @@ bool init_translation (const String &lang, const String &fallback_lang, bool qui
             return false;
         }
     }
+    invalidate_text_layout_cache();
     Out::FPrint("Translation initialized: %s", transFileName);
     return true;
 }
@@ -21,7 +21,9 @@
 #include "ac/gamesetupstruct.h"
 #include "ac/object.h"
 #include "ac/roomobject.h"
+#include "ac/roommask.h"
 #include "ac/roomstatus.h"
+#include "ac/route_finder.h"
 #include "ac/walkablearea.h"
 #include "gfx/bitmap.h"
 
@@ -56,11 +58,12 @@ void redo_walkable_areas() {
         }
     }
 
+    build_room_route_data(thisroom.walls);
 }
 
 int get_walkable_area_pixel(int x, int y)
 {
-    return thisroom.walls->GetPixel(convert_to_low_res(x), convert_to_low_res(y));
+    return get_mask_pixel(thisroom.walls, convert_to_low_res(x), convert_to_low_res(y));
 }
 
 int get_area_scaling (int onarea, int xx, int yy) {
@@ -120,17 +123,8 @@ void remove_walkable_areas_from_temp(int fromx, int cwidth, int starty, int endy
     starty = convert_to_low_res(starty);
     endy = convert_to_low_res(endy);
 
-    int yyy;
-    if (endy >= walkable_areas_temp->GetHeight())
-        endy = walkable_areas_temp->GetHeight() - 1;
-    if (starty < 0)
-        starty = 0;
-
-    for (; cwidth > 0; cwidth --) {
-        for (yyy = starty; yyy <= endy; yyy++)
-            walkable_areas_temp->PutPixel (fromx, yyy, 0);
-        fromx ++;
-    }
+    fill_mask_rect(walkable_areas_temp, fromx, starty, fromx + cwidth - 1, endy, 0);
+    add_route_blocker(fromx, starty, fromx + cwidth - 1, endy);
 
 }
 
@@ -143,6 +137,7 @@ int is_point_in_rect(int x, int y, int left, int top, int right, int bottom) {
 Bitmap *prepare_walkable_areas (int sourceChar) {
     // copy the walkable areas to the temp bitmap
     walkable_areas_temp->Blit (thisroom.walls, 0,0,0,0,thisroom.walls->GetWidth(),thisroom.walls->GetHeight());
+    begin_route_blockers(walkable_areas_temp);
     // if the character who's moving doesn't Bitmap *, don't bother checking
     if (sourceChar < 0) ;
     else if (game.chars[sourceChar].flags & CHF_NOBLOCKING)
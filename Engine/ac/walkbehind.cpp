@@ -30,11 +30,12 @@ extern GameState play;
 extern IGraphicsDriver *gfxDriver;
 
 
-char *walkBehindExists = NULL;  // whether a WB area is in this column
-int *walkBehindStartY = NULL, *walkBehindEndY = NULL;
 char noWalkBehindsAtAll = 0;
 int walkBehindLeft[MAX_OBJ], walkBehindTop[MAX_OBJ];
 int walkBehindRight[MAX_OBJ], walkBehindBottom[MAX_OBJ];
+// Coverage mask of each area, covering its bounding box only: one byte
+// per pixel, 0xFF where the pixel belongs to the area and 0 otherwise
+unsigned char *walkBehindMask[MAX_OBJ];
 IDriverDependantBitmap *walkBehindBitmap[MAX_OBJ];
 int walkBehindsCachedForBgNum = 0;
 WalkBehindMethodEnum walkBehindMethod = DrawOverCharSprite;
@@ -84,15 +85,6 @@ void update_walk_behind_images()
 
 
 void recache_walk_behinds () {
-  if (walkBehindExists) {
-    free (walkBehindExists);
-    free (walkBehindStartY);
-    free (walkBehindEndY);
-  }
-
-  walkBehindExists = (char*)malloc (thisroom.object->GetWidth());
-  walkBehindStartY = (int*)malloc (thisroom.object->GetWidth() * sizeof(int));
-  walkBehindEndY = (int*)malloc (thisroom.object->GetWidth() * sizeof(int));
   noWalkBehindsAtAll = 1;
 
   int ee,rr,tmm;
@@ -104,6 +96,9 @@ void recache_walk_behinds () {
     walkBehindRight[ee] = 0;
     walkBehindBottom[ee] = 0;
 
+    free(walkBehindMask[ee]);
+    walkBehindMask[ee] = NULL;
+
     if (walkBehindBitmap[ee] != NULL)
     {
       gfxDriver->DestroyDDB(walkBehindBitmap[ee]);
@@ -118,18 +113,12 @@ void recache_walk_behinds () {
   if ((!thisroom.object->IsLinearBitmap()) || (thisroom.object->GetColorDepth() != 8))
     quit("Walk behinds bitmap not linear");
 
-  for (ee=0;ee<thisroom.object->GetWidth();ee++) {
-    walkBehindExists[ee] = 0;
-    for (rr=0;rr<thisroom.object->GetHeight();rr++) {
-      tmm = thisroom.object->GetScanLine(rr)[ee];
-      //tmm = _getpixel(thisroom.object,ee,rr);
+  for (rr=0;rr<thisroom.object->GetHeight();rr++) {
+    const unsigned char *srcline = thisroom.object->GetScanLine(rr);
+    for (ee=0;ee<thisroom.object->GetWidth();ee++) {
+      tmm = srcline[ee];
       if ((tmm >= 1) && (tmm < MAX_OBJ)) {
-        if (!walkBehindExists[ee]) {
-          walkBehindStartY[ee] = rr;
-          walkBehindExists[ee] = tmm;
-          noWalkBehindsAtAll = 0;
-        }
-        walkBehindEndY[ee] = rr + 1;  // +1 to allow bottom line of screen to work
+        noWalkBehindsAtAll = 0;
 
         if (ee < walkBehindLeft[tmm]) walkBehindLeft[tmm] = ee;
         if (rr < walkBehindTop[tmm]) walkBehindTop[tmm] = rr;
@@ -139,6 +128,25 @@ void recache_walk_behinds () {
     }
   }
 
+  update_polled_stuff_if_runtime();
+
+  for (tmm = 1; tmm < MAX_OBJ; tmm++)
+  {
+    if (walkBehindLeft[tmm] > walkBehindRight[tmm])
+      continue;
+
+    const int maskWidth = (walkBehindRight[tmm] - walkBehindLeft[tmm]) + 1;
+    const int maskHeight = (walkBehindBottom[tmm] - walkBehindTop[tmm]) + 1;
+    walkBehindMask[tmm] = (unsigned char*)malloc(maskWidth * maskHeight);
+    for (rr = 0; rr < maskHeight; rr++)
+    {
+      const unsigned char *srcline = thisroom.object->GetScanLine(walkBehindTop[tmm] + rr) + walkBehindLeft[tmm];
+      unsigned char *maskline = walkBehindMask[tmm] + rr * maskWidth;
+      for (ee = 0; ee < maskWidth; ee++)
+        maskline[ee] = (srcline[ee] == tmm) ? 0xFF : 0;
+    }
+  }
+
   if (walkBehindMethod == DrawAsSeparateSprite)
   {
     update_walk_behind_images();
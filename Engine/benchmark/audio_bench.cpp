@@ -0,0 +1,445 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Audio decoding and mixing benchmark.
+//
+// Plays audio files with every clip type which can play them, through the
+// null sound driver mixing as fast as it can, and reports how many times
+// faster than real time each clip is decoded and mixed, and the share of
+// one CPU which each of several simultaneously playing copies of the clip
+// takes.
+//
+// Usage: audiobench [-channels <number>] [-seconds <number>] [files...]
+//
+// WAV, MIDI and MOD test files are generated on start. OGG and MP3 files,
+// which cannot be made without an encoder, and any other files to measure,
+// such as a game's own music and sounds, are given on the command line.
+// MIDI is only measured when Allegro finds DIGMID patches.
+//
+//=============================================================================
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <sys/resource.h>
+#include "util/wgt2allg.h"
+#include "ac/gamesetup.h"
+#include "media/audio/audio.h"
+#include "media/audio/nullsounddriver.h"
+#include "media/audio/sound.h"
+#include "media/audio/soundcache.h"
+#include "platform/base/agsplatformdriver.h"
+#include "util/math.h"
+
+namespace Math = AGS::Common::Math;
+
+// The engine globals and functions which the audio clips depend on
+GameSetup usetup;
+int our_eip;
+volatile int psp_audio_multithreaded = 0;
+volatile bool _audio_doing_crossfade = false;
+int psp_audio_cachesize = 10;
+int psp_midi_preload_patches = 0;
+
+void quit(const char *msg)
+{
+    fprintf(stderr, "audiobench: %s\n", msg);
+    exit(1);
+}
+
+void audio_thread_notify()
+{
+}
+
+AGSPlatformDriver *AGSPlatformDriver::GetDriver()
+{
+    // Only used for waiting for the audio thread, which is not running
+    return NULL;
+}
+
+const int MAX_BENCH_CHANNELS = 32;
+
+struct ClipType
+{
+    const char *Name;
+    const char *Extensions; // file extensions the clip plays, separated by spaces
+    bool        Simultaneous; // several clips may play at once
+    SOUNDCLIP *(*Load)(const char *filename);
+};
+
+SOUNDCLIP *bench_load_static_ogg(const char *filename) { return my_load_static_ogg(filename, 255, false); }
+SOUNDCLIP *bench_load_ogg(const char *filename) { return my_load_ogg(filename, 255); }
+SOUNDCLIP *bench_load_static_mp3(const char *filename) { return my_load_static_mp3(filename, 255, false); }
+SOUNDCLIP *bench_load_mp3(const char *filename) { return my_load_mp3(filename, 255); }
+SOUNDCLIP *bench_load_wave(const char *filename) { return my_load_wave(filename, 255, 0); }
+SOUNDCLIP *bench_load_mod(const char *filename) { return my_load_mod(filename, 0); }
+SOUNDCLIP *bench_load_midi(const char *filename) { return my_load_midi(filename, 0); }
+
+ClipType clip_types[] =
+{
+    { "staticogg", "ogg", true, bench_load_static_ogg },
+    { "ogg", "ogg", true, bench_load_ogg },
+    { "staticmp3", "mp3", true, bench_load_static_mp3 },
+    { "mp3", "mp3", true, bench_load_mp3 },
+    { "wave", "wav voc", true, bench_load_wave },
+    { "mod", "mod xm s3m it", true, bench_load_mod },
+    { "midi", "mid", false, bench_load_midi },
+};
+
+bool midi_available = false;
+
+int64_t get_cpu_time_us()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (int64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+        usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+bool has_extension(const char *filename, const char *extensions)
+{
+    const char *dot = strrchr(filename, '.');
+    if (dot == NULL)
+        return false;
+    const char *ext = dot + 1;
+    const size_t ext_len = strlen(ext);
+    for (const char *p = extensions; *p; )
+    {
+        const char *end = strchr(p, ' ');
+        const size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len == ext_len && ustrnicmp(p, ext, len) == 0)
+            return true;
+        p += len;
+        while (*p == ' ')
+            p++;
+    }
+    return false;
+}
+
+void write_le(FILE *f, unsigned value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        fputc((value >> (i * 8)) & 0xFF, f);
+}
+
+void write_be(FILE *f, unsigned value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; --i)
+        fputc((value >> (i * 8)) & 0xFF, f);
+}
+
+// 16-bit stereo tone sweep
+bool create_test_wave(const char *filename, int seconds)
+{
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return false;
+    const int freq = 44100;
+    const unsigned frames = seconds * freq;
+    fwrite("RIFF", 1, 4, f);
+    write_le(f, 36 + frames * 4, 4);
+    fwrite("WAVEfmt ", 1, 8, f);
+    write_le(f, 16, 4);
+    write_le(f, 1, 2);          // PCM
+    write_le(f, 2, 2);          // channels
+    write_le(f, freq, 4);
+    write_le(f, freq * 4, 4);   // bytes per second
+    write_le(f, 4, 2);          // block align
+    write_le(f, 16, 2);         // bits
+    fwrite("data", 1, 4, f);
+    write_le(f, frames * 4, 4);
+    double phase = 0.0;
+    for (unsigned i = 0; i < frames; ++i)
+    {
+        phase += 2.0 * M_PI * (220.0 + 660.0 * i / frames) / freq;
+        const short value = (short)(sin(phase) * 12000);
+        write_le(f, (unsigned short)value, 2);
+        write_le(f, (unsigned short)value, 2);
+    }
+    fclose(f);
+    return true;
+}
+
+void write_midi_delta(std::vector<unsigned char> &track, unsigned delta)
+{
+    unsigned char bytes[4];
+    int num = 0;
+    do
+    {
+        bytes[num++] = delta & 0x7F;
+        delta >>= 7;
+    }
+    while (delta);
+    while (num > 1)
+        track.push_back(bytes[--num] | 0x80);
+    track.push_back(bytes[0]);
+}
+
+// Arpeggios on piano and strings, at the default 120 beats per minute
+bool create_test_midi(const char *filename, int seconds)
+{
+    const int ticks_per_beat = 96;
+    const int note_ticks = ticks_per_beat / 4;
+    const int chord[4] = { 60, 64, 67, 72 };
+    std::vector<unsigned char> track;
+    const unsigned char programs[] = { 0x00, 0xC0, 0, 0x00, 0xC1, 48 };
+    track.insert(track.end(), programs, programs + sizeof(programs));
+    const int notes = seconds * 2 * 4; // sixteenths
+    for (int i = 0; i < notes; ++i)
+    {
+        const int note = chord[i % 4] + ((i / 16) % 3) * 2;
+        write_midi_delta(track, 0);
+        track.push_back(0x90); track.push_back(note); track.push_back(100);
+        if (i % 8 == 0)
+        {
+            write_midi_delta(track, 0);
+            track.push_back(0x91); track.push_back(note - 12); track.push_back(80);
+        }
+        write_midi_delta(track, note_ticks);
+        track.push_back(0x80); track.push_back(note); track.push_back(0);
+        if (i % 8 == 7)
+        {
+            write_midi_delta(track, 0);
+            track.push_back(0x81); track.push_back(chord[(i - 7) % 4] + ((i / 16) % 3) * 2 - 12); track.push_back(0);
+        }
+    }
+    const unsigned char end_of_track[] = { 0x00, 0xFF, 0x2F, 0x00 };
+    track.insert(track.end(), end_of_track, end_of_track + sizeof(end_of_track));
+
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return false;
+    fwrite("MThd", 1, 4, f);
+    write_be(f, 6, 4);
+    write_be(f, 0, 2);  // single track format
+    write_be(f, 1, 2);
+    write_be(f, ticks_per_beat, 2);
+    fwrite("MTrk", 1, 4, f);
+    write_be(f, track.size(), 4);
+    fwrite(&track[0], 1, track.size(), f);
+    fclose(f);
+    return true;
+}
+
+// Four channel ProTracker module with a looped sine instrument
+bool create_test_mod(const char *filename, int seconds)
+{
+    const int rows = 64, channels = 4;
+    // a pattern at the default speed lasts 64 rows * 6 ticks * 20 ms
+    const int num_patterns = Math::Max(1, (seconds * 1000 + 7679) / 7680);
+    const int sample_len = 64;
+    const int periods[8] = { 428, 381, 339, 320, 285, 254, 226, 214 };
+
+    FILE *f = fopen(filename, "wb");
+    if (!f)
+        return false;
+    char name[22];
+    memset(name, 0, sizeof(name));
+    strcpy(name, "audiobench");
+    fwrite(name, 1, 20, f);
+    for (int s = 0; s < 31; ++s)
+    {
+        fwrite(name, 1, 22, f);
+        write_be(f, s == 0 ? sample_len / 2 : 0, 2);   // length in words
+        fputc(0, f);                                    // finetune
+        fputc(s == 0 ? 64 : 0, f);                      // volume
+        write_be(f, 0, 2);                              // loop start
+        write_be(f, s == 0 ? sample_len / 2 : 1, 2);    // loop length
+    }
+    fputc(num_patterns, f);
+    fputc(127, f);
+    for (int i = 0; i < 128; ++i)
+        fputc(i < num_patterns ? i : 0, f);
+    fwrite("M.K.", 1, 4, f);
+    for (int p = 0; p < num_patterns; ++p)
+    {
+        for (int r = 0; r < rows; ++r)
+        {
+            for (int c = 0; c < channels; ++c)
+            {
+                if ((r + c * 2) % 4 != 0)
+                {
+                    write_be(f, 0, 4);
+                    continue;
+                }
+                const int period = periods[(r / 4 + c * 2 + p) % 8] >> (c / 2);
+                fputc(0x00 | (period >> 8), f);         // sample 1, period high bits
+                fputc(period & 0xFF, f);
+                fputc(0x10, f);                         // sample 1, no effect
+                fputc(0x00, f);
+            }
+        }
+    }
+    for (int i = 0; i < sample_len; ++i)
+        fputc((unsigned char)(signed char)(sin(2.0 * M_PI * i / sample_len) * 100), f);
+    fclose(f);
+    return true;
+}
+
+void delete_clip(SOUNDCLIP *clip)
+{
+    clip->destroy();
+    delete clip;
+}
+
+// Plays the clip once from start to end, or for the given time; returns the
+// played time in milliseconds and the CPU time it took
+bool run_decode(const ClipType &type, const char *filename, int max_seconds, int &played_ms, int64_t &cpu_us)
+{
+    SOUNDCLIP *clip = type.Load(filename);
+    if (!clip)
+        return false;
+    const int frames_per_mix = null_sound_driver_buffer_frames();
+    const int freq = null_sound_driver_frequency();
+    const int max_mixes = max_seconds * freq / frames_per_mix;
+    int mixes = 0;
+    const int64_t start = get_cpu_time_us();
+    // A clip which fails to play deletes itself
+    const bool played = clip->play() != 0;
+    if (played)
+    {
+        for (; mixes < max_mixes; ++mixes)
+        {
+            if (clip->poll())
+                break;
+            null_sound_driver_mix();
+        }
+    }
+    cpu_us = get_cpu_time_us() - start;
+    played_ms = (int)((int64_t)mixes * frames_per_mix * 1000 / freq);
+    if (played)
+        delete_clip(clip);
+    return played_ms > 0;
+}
+
+// Plays several copies of the clip at once for the given time, restarting
+// those which end; returns the CPU time it took
+int64_t run_channels(const ClipType &type, const char *filename, int num_channels, int seconds)
+{
+    std::vector<SOUNDCLIP*> clips(num_channels, (SOUNDCLIP*)NULL);
+    const int frames_per_mix = null_sound_driver_buffer_frames();
+    const int num_mixes = seconds * null_sound_driver_frequency() / frames_per_mix;
+    const int64_t start = get_cpu_time_us();
+    for (int m = 0; m < num_mixes; ++m)
+    {
+        for (int c = 0; c < num_channels; ++c)
+        {
+            if (clips[c] && clips[c]->poll())
+            {
+                delete_clip(clips[c]);
+                clips[c] = NULL;
+            }
+            if (!clips[c])
+            {
+                clips[c] = type.Load(filename);
+                // a clip which fails to play deletes itself
+                if (clips[c] && !clips[c]->play())
+                    clips[c] = NULL;
+            }
+        }
+        null_sound_driver_mix();
+    }
+    const int64_t cpu_us = get_cpu_time_us() - start;
+    for (int c = 0; c < num_channels; ++c)
+    {
+        if (clips[c])
+            delete_clip(clips[c]);
+    }
+    return cpu_us;
+}
+
+int main(int argc, char *argv[])
+{
+    int num_channels = 8;
+    int seconds = 10;
+    std::vector<const char*> files;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-channels") == 0 && i + 1 < argc)
+            num_channels = Math::Clamp(1, MAX_BENCH_CHANNELS, atoi(argv[++i]));
+        else if (strcmp(argv[i], "-seconds") == 0 && i + 1 < argc)
+            seconds = Math::Max(1, atoi(argv[++i]));
+        else
+            files.push_back(argv[i]);
+    }
+
+    install_allegro(SYSTEM_NONE, &errno, atexit);
+    install_timer();
+    if (!register_null_sound_driver(false))
+        quit("null sound driver is not supported on this platform");
+    reserve_voices(MAX_BENCH_CHANNELS + 4, -1);
+    set_volume_per_voice(1);
+    if (install_sound(DIGI_AGS_NULL, MIDI_DIGMID, NULL) == 0)
+        midi_available = true;
+    else if (install_sound(DIGI_AGS_NULL, MIDI_NONE, NULL) != 0)
+        quit("failed to install the null sound driver");
+    init_mod_player(MAX_BENCH_CHANNELS);
+    // Measure the decoders rather than the decoded sound cache
+    usetup.decoded_sound_cache_size = 0;
+    clear_sound_cache();
+
+    const char *generated[] = { "audiobench_test.wav", "audiobench_test.mid", "audiobench_test.mod" };
+    if (!create_test_wave(generated[0], seconds) || !create_test_midi(generated[1], seconds) ||
+        !create_test_mod(generated[2], seconds))
+        quit("failed to write the test files to the current directory");
+    files.insert(files.begin(), generated, generated + sizeof(generated) / sizeof(generated[0]));
+
+    char channels_title[32];
+    sprintf(channels_title, "cpu%%/ch(%d)", num_channels);
+    printf("%-28s %-10s %8s %10s %12s\n", "file", "clip", "played_s", "realtime_x", channels_title);
+    for (size_t f = 0; f < files.size(); ++f)
+    {
+        const char *filename = files[f];
+        const char *shortname = strrchr(filename, '/') ? strrchr(filename, '/') + 1 : filename;
+        for (size_t t = 0; t < sizeof(clip_types) / sizeof(clip_types[0]); ++t)
+        {
+            const ClipType &type = clip_types[t];
+            if (!has_extension(filename, type.Extensions))
+                continue;
+            if (type.Load == bench_load_midi && !midi_available)
+            {
+                printf("%-28s %-10s skipped, no MIDI patches\n", shortname, type.Name);
+                continue;
+            }
+
+            int played_ms;
+            int64_t cpu_us;
+            if (!run_decode(type, filename, seconds, played_ms, cpu_us))
+            {
+                printf("%-28s %-10s failed to play\n", shortname, type.Name);
+                continue;
+            }
+            printf("%-28s %-10s %8.2f %10.1f", shortname, type.Name, played_ms / 1000.0,
+                cpu_us > 0 ? played_ms * 1000.0 / cpu_us : 0.0);
+            if (type.Simultaneous)
+            {
+                const int64_t channels_us = run_channels(type, filename, num_channels, seconds);
+                printf(" %12.2f\n", channels_us * 100.0 / (seconds * 1000000.0) / num_channels);
+            }
+            else
+            {
+                printf(" %12s\n", "-");
+            }
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(generated) / sizeof(generated[0]); ++i)
+        remove(generated[i]);
+    remove_sound();
+    return 0;
+}
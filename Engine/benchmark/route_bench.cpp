@@ -0,0 +1,276 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Route finder benchmark.
+//
+// Runs find_route between random pairs of walkable points on a set of
+// walkable area masks, with each of the pathfinders over the same pairs, and
+// reports the number of routes per second, the length of the found paths
+// compared to the straight distance, and the most memory the route finder's
+// working buffers took for a single route.
+//
+// Usage: routebench [-n <routes per mask>] [-seed <number>] [mask files...]
+//
+// Besides the built-in synthetic masks, any 8-bit BMP or PCX images may be
+// given, where the colour index is the number of the walkable area.
+//
+//=============================================================================
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "ac/gamesetup.h"
+#include "ac/movelist.h"
+#include "ac/roommask.h"
+#include "ac/route_finder.h"
+#include "gfx/bitmap.h"
+#include "util/clock.h"
+#include "util/math.h"
+
+using AGS::Common::Bitmap;
+namespace BitmapHelper = AGS::Common::BitmapHelper;
+namespace Math = AGS::Common::Math;
+
+// The engine globals and functions which the route finder depends on
+GameSetup usetup;
+MoveList *mls;
+
+void quit(const char *msg)
+{
+    fprintf(stderr, "routebench: %s\n", msg);
+    exit(1);
+}
+
+void update_polled_stuff_if_runtime()
+{
+}
+
+// Move list slot used for the calculated routes
+const int BENCH_MOVE_LIST = 1;
+
+struct BenchMask
+{
+    const char *Name;
+    Bitmap     *Mask;
+};
+
+struct RoutePair
+{
+    int FromX, FromY;
+    int ToX, ToY;
+};
+
+struct BenchResult
+{
+    int     Found;      // routes calculated
+    int     Reached;    // routes which end at the requested destination
+    double  LengthRatio;// sum of path length to straight distance ratios
+    int64_t TotalTime;  // in microseconds
+    int64_t MaxTime;
+};
+
+Bitmap *create_mask(int width, int height)
+{
+    Bitmap *mask = BitmapHelper::CreateBitmap(width, height, 8);
+    if (!mask)
+        quit("failed to create mask bitmap");
+    fill_mask_rect(mask, 0, 0, width - 1, height - 1, 0);
+    return mask;
+}
+
+// Small room with a few obstacles on the floor
+Bitmap *create_open_room()
+{
+    Bitmap *mask = create_mask(320, 200);
+    fill_mask_rect(mask, 10, 100, 309, 195, 1);
+    fill_mask_rect(mask, 60, 130, 90, 150, 0);
+    fill_mask_rect(mask, 150, 110, 170, 185, 0);
+    fill_mask_rect(mask, 230, 140, 280, 160, 0);
+    return mask;
+}
+
+// Wide scrolling room with several walkable areas, furniture and a
+// narrow bridge in the middle
+Bitmap *create_scrolling_room()
+{
+    Bitmap *mask = create_mask(1600, 240);
+    fill_mask_rect(mask, 5, 130, 700, 235, 1);
+    fill_mask_rect(mask, 701, 175, 900, 178, 2);
+    fill_mask_rect(mask, 901, 120, 1594, 235, 3);
+    fill_mask_rect(mask, 300, 60, 420, 129, 4);
+    for (int x = 60; x < 700; x += 110)
+        fill_mask_rect(mask, x, 150 + (x % 3) * 20, x + 40, 165 + (x % 3) * 20, 0);
+    for (int x = 950; x < 1594; x += 90)
+        fill_mask_rect(mask, x, 130 + (x % 4) * 25, x + 30, 150 + (x % 4) * 25, 0);
+    return mask;
+}
+
+// Maze of narrow corridors
+Bitmap *create_maze(int cols, int rows)
+{
+    const int cell = 10, wall = 3;
+    Bitmap *mask = create_mask(cols * cell + wall, rows * cell + wall);
+    std::vector<char> visited(cols * rows, 0);
+    std::vector<int> stack;
+    stack.push_back(0);
+    visited[0] = 1;
+    while (!stack.empty())
+    {
+        const int at = stack.back();
+        const int cx = at % cols, cy = at / cols;
+        fill_mask_rect(mask, cx * cell + wall, cy * cell + wall, (cx + 1) * cell - 1, (cy + 1) * cell - 1, 1);
+
+        int next[4], num_next = 0;
+        if (cx > 0 && !visited[at - 1]) next[num_next++] = at - 1;
+        if (cx < cols - 1 && !visited[at + 1]) next[num_next++] = at + 1;
+        if (cy > 0 && !visited[at - cols]) next[num_next++] = at - cols;
+        if (cy < rows - 1 && !visited[at + cols]) next[num_next++] = at + cols;
+        if (num_next == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+        const int to = next[rand() % num_next];
+        const int tx = to % cols, ty = to / cols;
+        // open the wall between the cells
+        fill_mask_rect(mask, Math::Min(cx, tx) * cell + wall, Math::Min(cy, ty) * cell + wall,
+            (Math::Max(cx, tx) + 1) * cell - 1, (Math::Max(cy, ty) + 1) * cell - 1, 1);
+        visited[to] = 1;
+        stack.push_back(to);
+    }
+    return mask;
+}
+
+void get_random_walkable_point(Bitmap *mask, int &x, int &y)
+{
+    do
+    {
+        x = rand() % mask->GetWidth();
+        y = rand() % mask->GetHeight();
+    }
+    while (get_mask_pixel(mask, x, y) <= 0);
+}
+
+BenchResult run_benchmark(Bitmap *mask, const std::vector<RoutePair> &pairs)
+{
+    BenchResult result;
+    memset(&result, 0, sizeof(result));
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        const RoutePair &pair = pairs[i];
+        const int64_t start = AGS::Engine::GetClockMicroseconds();
+        const int slot = find_route(pair.FromX, pair.FromY, pair.ToX, pair.ToY, mask, BENCH_MOVE_LIST, 1);
+        const int64_t time = AGS::Engine::GetClockMicroseconds() - start;
+        result.TotalTime += time;
+        if (time > result.MaxTime)
+            result.MaxTime = time;
+        if (slot == 0)
+            continue;
+
+        result.Found++;
+        const MoveList &route = mls[slot];
+        const int last = route.pos[route.numstage - 1];
+        if (((last >> 16) & 0xffff) != pair.ToX || (last & 0xffff) != pair.ToY)
+            continue;
+        result.Reached++;
+        double length = 0.0;
+        for (int s = 1; s < route.numstage; ++s)
+        {
+            const int dx = ((route.pos[s] >> 16) & 0xffff) - ((route.pos[s - 1] >> 16) & 0xffff);
+            const int dy = (route.pos[s] & 0xffff) - (route.pos[s - 1] & 0xffff);
+            length += sqrt((double)(dx * dx + dy * dy));
+        }
+        const int dx = pair.ToX - pair.FromX, dy = pair.ToY - pair.FromY;
+        const double straight = sqrt((double)(dx * dx + dy * dy));
+        result.LengthRatio += straight > 0.0 ? length / straight : 1.0;
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    int num_routes = 200;
+    int seed = 1;
+    std::vector<BenchMask> masks;
+
+    install_allegro(SYSTEM_NONE, &errno, atexit);
+    init_pathfinder();
+    mls = (MoveList *)calloc(BENCH_MOVE_LIST + 1, sizeof(MoveList));
+    set_route_move_speed(2, 2);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            num_routes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-seed") == 0 && i + 1 < argc)
+            seed = atoi(argv[++i]);
+        else
+        {
+            Bitmap *mask = BitmapHelper::LoadFromFile(argv[i]);
+            if (!mask || mask->GetColorDepth() != 8)
+            {
+                fprintf(stderr, "routebench: %s is not an 8-bit image, skipped\n", argv[i]);
+                delete mask;
+                continue;
+            }
+            BenchMask bench_mask = { argv[i], mask };
+            masks.push_back(bench_mask);
+        }
+    }
+
+    srand(seed);
+    BenchMask builtin[] =
+    {
+        { "open", create_open_room() },
+        { "scrolling", create_scrolling_room() },
+        { "maze", create_maze(40, 28) },
+    };
+    masks.insert(masks.begin(), builtin, builtin + sizeof(builtin) / sizeof(builtin[0]));
+
+    const char *pathfinder_names[kNumPathfinderTypes] = { "legacy", "astar" };
+    printf("%-12s %-8s %10s %8s %8s %8s %10s %10s\n",
+        "mask", "finder", "routes/s", "found%", "reached%", "length", "max_ms", "peak_kb");
+    for (size_t m = 0; m < masks.size(); ++m)
+    {
+        std::vector<RoutePair> pairs(num_routes);
+        for (int i = 0; i < num_routes; ++i)
+        {
+            get_random_walkable_point(masks[m].Mask, pairs[i].FromX, pairs[i].FromY);
+            get_random_walkable_point(masks[m].Mask, pairs[i].ToX, pairs[i].ToY);
+        }
+
+        for (int f = 0; f < kNumPathfinderTypes; ++f)
+        {
+            usetup.pathfinder = (PathfinderType)f;
+            get_route_finder_peak_memory();
+            BenchResult result = run_benchmark(masks[m].Mask, pairs);
+            const int peak_kb = (int)(get_route_finder_peak_memory() / 1024);
+            printf("%-12s %-8s %10.1f %8.1f %8.1f %8.3f %10.2f %10d\n",
+                masks[m].Name, pathfinder_names[f],
+                result.TotalTime > 0 ? num_routes * 1000000.0 / result.TotalTime : 0.0,
+                num_routes > 0 ? result.Found * 100.0 / num_routes : 0.0,
+                num_routes > 0 ? result.Reached * 100.0 / num_routes : 0.0,
+                result.Reached > 0 ? result.LengthRatio / result.Reached : 0.0,
+                result.MaxTime / 1000.0, peak_kb);
+        }
+    }
+
+    for (size_t m = 0; m < masks.size(); ++m)
+        delete masks[m].Mask;
+    free(mls);
+    return 0;
+}
@@ -0,0 +1,207 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <string.h>
+#include "debug/frametimer.h"
+#include "debug/out.h"
+#include "util/file.h"
+#include "util/textstreamwriter.h"
+
+using AGS::Common::String;
+using AGS::Common::TextStreamWriter;
+namespace Out = AGS::Common::Out;
+
+namespace FrameTimer
+{
+
+// Number of last frames kept in the rolling histogram
+const int FrameWindow      = 1000;
+// Histogram bucket size, in microseconds
+const int BucketSize       = 100;
+// Number of histogram buckets; the last one takes all the larger values
+const int BucketCount      = 1000;
+
+const char *PhaseNames[kNumFramePhases] =
+{
+    "frame", "work", "controls", "update", "audio", "render", "events", "wait",
+    "sprites", "walkbehinds", "gui", "driver"
+};
+
+struct PhaseHistory
+{
+    int Times[FrameWindow];     // ring buffer of the recorded times
+    int Buckets[BucketCount];   // number of recorded times per bucket
+};
+
+bool             Enabled = false;
+PhaseHistory     History[kNumFramePhases];
+int64_t          CurrentFrame[kNumFramePhases];
+int              FrameCount = 0;      // total frames recorded
+int64_t          FrameStart = 0;
+TextStreamWriter *DumpWriter = NULL;
+int              DumpInterval = 0;
+
+inline int GetBucket(int time_us)
+{
+    int bucket = time_us / BucketSize;
+    return bucket < BucketCount ? bucket : BucketCount - 1;
+}
+
+void Reset()
+{
+    memset(History, 0, sizeof(History));
+    memset(CurrentFrame, 0, sizeof(CurrentFrame));
+    FrameCount = 0;
+    FrameStart = 0;
+}
+
+void Enable(bool on)
+{
+    if (on && !Enabled)
+        Reset();
+    Enabled = on;
+}
+
+bool IsEnabled()
+{
+    return Enabled;
+}
+
+void SetDumpFile(const String &filename, int interval)
+{
+    delete DumpWriter;
+    DumpWriter = NULL;
+    DumpInterval = interval > 0 ? interval : FrameWindow;
+    if (filename.IsEmpty())
+        return;
+
+    AGS::Common::Stream *out = AGS::Common::File::CreateFile(filename);
+    if (!out)
+    {
+        Out::FPrint("FrameTimer: failed to open %s for writing", filename.GetCStr());
+        return;
+    }
+    DumpWriter = new TextStreamWriter(out);
+    DumpWriter->WriteLine("frame,phase,p50_us,p90_us,p99_us,max_us");
+}
+
+void Dump()
+{
+    for (int i = 0; i < kNumFramePhases; ++i)
+    {
+        FramePhase phase = (FramePhase)i;
+        DumpWriter->WriteFormat("%d,%s,%d,%d,%d,%d\n", FrameCount, PhaseNames[i],
+            GetPercentile(phase, 50), GetPercentile(phase, 90), GetPercentile(phase, 99), GetMax(phase));
+    }
+}
+
+void CommitFrame(int64_t frame_time)
+{
+    CurrentFrame[kFramePhase_Frame] = frame_time;
+    CurrentFrame[kFramePhase_Work] = frame_time - CurrentFrame[kFramePhase_Wait];
+
+    const int slot = FrameCount % FrameWindow;
+    for (int i = 0; i < kNumFramePhases; ++i)
+    {
+        PhaseHistory &history = History[i];
+        if (FrameCount >= FrameWindow)
+            history.Buckets[GetBucket(history.Times[slot])]--;
+        const int time_us = (int)CurrentFrame[i];
+        history.Times[slot] = time_us;
+        history.Buckets[GetBucket(time_us)]++;
+    }
+    FrameCount++;
+
+    if (DumpWriter && (FrameCount % DumpInterval) == 0)
+        Dump();
+}
+
+void StartFrame()
+{
+    const bool traced = Tracer::IsEnabled();
+    if (!Enabled && !traced)
+        return;
+
+    const int64_t now = AGS::Engine::GetClockMicroseconds();
+    if (FrameStart != 0)
+    {
+        if (Enabled)
+            CommitFrame(now - FrameStart);
+        if (traced)
+            Tracer::AddEvent("loop", PhaseNames[kFramePhase_Frame], FrameStart, now - FrameStart);
+    }
+    memset(CurrentFrame, 0, sizeof(CurrentFrame));
+    FrameStart = now;
+}
+
+void AddPhaseTime(FramePhase phase, int64_t time_us)
+{
+    if (!Enabled)
+        return;
+    CurrentFrame[phase] += time_us;
+}
+
+const char *GetPhaseName(FramePhase phase)
+{
+    return PhaseNames[phase];
+}
+
+int GetPercentile(FramePhase phase, int percent)
+{
+    const int count = FrameCount < FrameWindow ? FrameCount : FrameWindow;
+    if (count == 0)
+        return 0;
+
+    // Find the bucket which contains the wanted rank, and report its upper
+    // bound, but not more than the actual maximum; the last bucket also
+    // holds every longer time, so it has no bound of its own
+    const int rank = (count * percent + 99) / 100;
+    const PhaseHistory &history = History[phase];
+    int sum = 0;
+    for (int i = 0; i < BucketCount; ++i)
+    {
+        sum += history.Buckets[i];
+        if (sum >= rank)
+        {
+            const int max = GetMax(phase);
+            if (i == BucketCount - 1)
+                return max;
+            const int bound = (i + 1) * BucketSize;
+            return bound < max ? bound : max;
+        }
+    }
+    return GetMax(phase);
+}
+
+int GetMax(FramePhase phase)
+{
+    const int count = FrameCount < FrameWindow ? FrameCount : FrameWindow;
+    const PhaseHistory &history = History[phase];
+    int max = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (history.Times[i] > max)
+            max = history.Times[i];
+    }
+    return max;
+}
+
+void Shutdown()
+{
+    delete DumpWriter;
+    DumpWriter = NULL;
+    Enabled = false;
+}
+
+} // namespace FrameTimer
@@ -0,0 +1,102 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Frame timing instrumentation.
+//
+// Measures time spent in the phases of the game loop and keeps a rolling
+// histogram of the last frames for each of them, from which percentiles
+// are calculated. Results may be displayed on screen, or periodically
+// written to a CSV file.
+//
+//=============================================================================
+#ifndef __AGS_EE_DEBUG__FRAMETIMER_H
+#define __AGS_EE_DEBUG__FRAMETIMER_H
+
+#include "debug/tracer.h"
+#include "util/clock.h"
+#include "util/string.h"
+
+enum FramePhase
+{
+    kFramePhase_Frame,          // whole frame, from one game loop start to the next
+    kFramePhase_Work,           // whole frame except for waiting for the next tick
+    kFramePhase_Controls,       // processing player input
+    kFramePhase_Update,         // updating game state
+    kFramePhase_Audio,          // polling audio and crossfades
+    kFramePhase_Render,         // rendering the frame
+    kFramePhase_Events,         // running queued events
+    kFramePhase_Wait,           // waiting for the next game tick
+    kFramePhase_Sprites,        // render: preparing room objects and characters
+    kFramePhase_WalkBehinds,    // render: cutting sprites by walk-behinds
+    kFramePhase_GUI,            // render: redrawing GUI
+    kFramePhase_DriverRender,   // render: graphics driver presenting the frame
+    kNumFramePhases
+};
+
+namespace FrameTimer
+{
+    // Enable or disable timing collection
+    void Enable(bool on);
+    bool IsEnabled();
+    // Sets file to write the statistics to every "interval" frames;
+    // pass empty filename to disable
+    void SetDumpFile(const AGS::Common::String &filename, int interval);
+    // Marks the beginning of the new frame, commits previous frame's timings
+    void StartFrame();
+    // Adds time spent in the phase, in microseconds, to the current frame
+    void AddPhaseTime(FramePhase phase, int64_t time_us);
+    // Gets the phase's name
+    const char *GetPhaseName(FramePhase phase);
+    // Gets the time in microseconds below which the given percentage of the
+    // recorded frames fall for the phase
+    int  GetPercentile(FramePhase phase, int percent);
+    // Gets maximal recorded phase time in microseconds
+    int  GetMax(FramePhase phase);
+    // Closes dump file
+    void Shutdown();
+}
+
+// Measures the time spent in a phase during its lifetime; also records
+// the phase to the activity trace, if one is enabled
+class FramePhaseScope
+{
+public:
+    FramePhaseScope(FramePhase phase)
+        : _phase(phase)
+        , _timed(FrameTimer::IsEnabled())
+        , _traced(Tracer::IsEnabled())
+    {
+        if (_timed || _traced)
+            _start = AGS::Engine::GetClockMicroseconds();
+    }
+
+    ~FramePhaseScope()
+    {
+        if (!_timed && !_traced)
+            return;
+        const int64_t duration = AGS::Engine::GetClockMicroseconds() - _start;
+        if (_timed)
+            FrameTimer::AddPhaseTime(_phase, duration);
+        if (_traced)
+            Tracer::AddEvent("loop", FrameTimer::GetPhaseName(_phase), _start, duration);
+    }
+
+private:
+    FramePhase _phase;
+    bool       _timed;
+    bool       _traced;
+    int64_t    _start;
+};
+
+#endif // __AGS_EE_DEBUG__FRAMETIMER_H
@@ -0,0 +1,230 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <string.h>
+#include <vector>
+#include "debug/tracer.h"
+#include "debug/out.h"
+#include "util/file.h"
+#include "util/math.h"
+#include "util/mutex.h"
+#include "util/mutex_lock.h"
+#include "util/textstreamwriter.h"
+
+#if defined(_MSC_VER)
+#define AGS_THREAD_LOCAL __declspec(thread)
+#else
+#define AGS_THREAD_LOCAL __thread
+#endif
+
+using AGS::Common::String;
+using AGS::Common::TextStreamWriter;
+using AGS::Engine::Mutex;
+using AGS::Engine::MutexLock;
+namespace Out = AGS::Common::Out;
+namespace Math = AGS::Common::Math;
+
+namespace Tracer
+{
+
+// Number of last events kept for each thread
+const int EventBufferSize = 32768;
+const int MaxEventName    = 40;
+
+struct TraceEvent
+{
+    char        Phase;      // 'X' for events with duration, 'i' for instant
+    char        Name[MaxEventName];
+    const char *Category;
+    const char *ArgName;
+    int         Arg;
+    int64_t     Start;
+    int64_t     Duration;
+};
+
+struct ThreadBuffer
+{
+    Mutex       Lock;       // guards against writing the trace while adding events
+    int         ThreadId;
+    String      Name;
+    TraceEvent *Events;
+    int         Count;
+    int         Next;
+};
+
+bool                        Enabled = false;
+String                      TraceFile;
+int64_t                     TraceStart = 0;
+int                         SnapshotCount = 0;
+Mutex                       BuffersLock;
+std::vector<ThreadBuffer*>  Buffers;
+AGS_THREAD_LOCAL ThreadBuffer *CurrentBuffer = NULL;
+
+ThreadBuffer *GetThreadBuffer()
+{
+    if (CurrentBuffer)
+        return CurrentBuffer;
+
+    ThreadBuffer *buf = new ThreadBuffer();
+    buf->Events = new TraceEvent[EventBufferSize];
+    buf->Count = 0;
+    buf->Next = 0;
+    MutexLock lock(BuffersLock);
+    buf->ThreadId = Buffers.size() + 1;
+    Buffers.push_back(buf);
+    CurrentBuffer = buf;
+    return buf;
+}
+
+void PushEvent(char phase, const char *category, const char *name, int64_t start_us, int64_t duration_us,
+               const char *arg_name, int arg)
+{
+    ThreadBuffer *buf = GetThreadBuffer();
+    MutexLock lock(buf->Lock);
+    TraceEvent &ev = buf->Events[buf->Next];
+    ev.Phase = phase;
+    strncpy(ev.Name, name, MaxEventName - 1);
+    ev.Name[MaxEventName - 1] = 0;
+    ev.Category = category;
+    ev.ArgName = arg_name;
+    ev.Arg = arg;
+    ev.Start = start_us - TraceStart;
+    ev.Duration = duration_us;
+    buf->Next = (buf->Next + 1) % EventBufferSize;
+    if (buf->Count < EventBufferSize)
+        buf->Count++;
+}
+
+void Init(const String &filename)
+{
+    TraceFile = filename;
+    TraceStart = AGS::Engine::GetClockMicroseconds();
+    SnapshotCount = 0;
+    Enabled = true;
+}
+
+bool IsEnabled()
+{
+    return Enabled;
+}
+
+void SetThreadName(const char *name)
+{
+    if (!Enabled)
+        return;
+    ThreadBuffer *buf = GetThreadBuffer();
+    MutexLock lock(buf->Lock);
+    buf->Name = name;
+}
+
+void AddEvent(const char *category, const char *name, int64_t start_us, int64_t duration_us,
+              const char *arg_name, int arg)
+{
+    if (Enabled)
+        PushEvent('X', category, name, start_us, duration_us, arg_name, arg);
+}
+
+void AddInstantEvent(const char *category, const char *name, const char *arg_name, int arg)
+{
+    if (Enabled)
+        PushEvent('i', category, name, AGS::Engine::GetClockMicroseconds(), 0, arg_name, arg);
+}
+
+void WriteEvent(TextStreamWriter *out, const TraceEvent &ev, int tid, bool &first)
+{
+    out->WriteFormat("%s\n{\"name\":\"", first ? "" : ",");
+    first = false;
+    // Event names are mostly script function names, but stay on the safe side
+    for (const char *c = ev.Name; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            out->WriteChar('\\');
+        out->WriteChar(*c >= ' ' ? *c : '?');
+    }
+    out->WriteFormat("\",\"cat\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%lld",
+        ev.Category, ev.Phase, tid, (long long)ev.Start);
+    if (ev.Phase == 'X')
+        out->WriteFormat(",\"dur\":%lld", (long long)ev.Duration);
+    else
+        out->WriteString(",\"s\":\"t\"");
+    if (ev.ArgName)
+        out->WriteFormat(",\"args\":{\"%s\":%d}", ev.ArgName, ev.Arg);
+    out->WriteChar('}');
+}
+
+void WriteTrace(const String &filename)
+{
+    AGS::Common::Stream *s = AGS::Common::File::CreateFile(filename);
+    if (!s)
+    {
+        Out::FPrint("Tracer: failed to open %s for writing", filename.GetCStr());
+        return;
+    }
+    TextStreamWriter out(s);
+    out.WriteString("{\"traceEvents\":[");
+    bool first = true;
+    std::vector<TraceEvent> events;
+
+    MutexLock lock(BuffersLock);
+    for (size_t i = 0; i < Buffers.size(); ++i)
+    {
+        ThreadBuffer *buf = Buffers[i];
+        // Copy events out, so that the thread is not blocked by file writing
+        MutexLock buf_lock(buf->Lock);
+        const int count = buf->Count;
+        const int from = (buf->Next - count + EventBufferSize) % EventBufferSize;
+        events.resize(count);
+        for (int e = 0; e < count; ++e)
+            events[e] = buf->Events[(from + e) % EventBufferSize];
+        String name = buf->Name;
+        buf_lock.Release();
+
+        if (!name.IsEmpty())
+        {
+            out.WriteFormat("%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", buf->ThreadId, name.GetCStr());
+            first = false;
+        }
+        for (int e = 0; e < count; ++e)
+            WriteEvent(&out, events[e], buf->ThreadId, first);
+    }
+    out.WriteString("\n]}\n");
+    Out::FPrint("Tracer: written trace to %s", filename.GetCStr());
+}
+
+void WriteSnapshot()
+{
+    if (!Enabled)
+        return;
+    // trace.json -> trace-001.json
+    String filename = TraceFile;
+    int ext_at = filename.FindCharReverse('.');
+    int dir_at = Math::Max(filename.FindCharReverse('/'), filename.FindCharReverse('\\'));
+    if (ext_at <= dir_at)
+        ext_at = filename.GetLength();
+    filename = String::FromFormat("%s-%03d%s", filename.Left(ext_at).GetCStr(), ++SnapshotCount,
+        filename.Mid(ext_at).GetCStr());
+    WriteTrace(filename);
+}
+
+void Shutdown()
+{
+    if (!Enabled)
+        return;
+    WriteTrace(TraceFile);
+    // Buffers are not freed, because other threads may still hold them
+    Enabled = false;
+}
+
+} // namespace Tracer
@@ -0,0 +1,79 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Engine activity tracing.
+//
+// Records timed events into the per-thread ring buffers, which keep only
+// the most recent events; the buffers are written to a file in the Chrome
+// trace-event JSON format on engine exit, or on request (see WriteSnapshot).
+// The resulting file may be opened by chrome://tracing or similar viewer.
+//
+//=============================================================================
+#ifndef __AGS_EE_DEBUG__TRACER_H
+#define __AGS_EE_DEBUG__TRACER_H
+
+#include "util/clock.h"
+#include "util/string.h"
+
+namespace Tracer
+{
+    // Enables tracing; the trace will be written to the given file on shutdown
+    void Init(const AGS::Common::String &filename);
+    bool IsEnabled();
+    // Names the calling thread in the trace
+    void SetThreadName(const char *name);
+    // Adds an event which has duration; the name is copied, while category and
+    // argument name must be static strings. Pass NULL arg_name to have no argument.
+    void AddEvent(const char *category, const char *name, int64_t start_us, int64_t duration_us,
+                  const char *arg_name = NULL, int arg = 0);
+    // Adds an event which has no duration
+    void AddInstantEvent(const char *category, const char *name, const char *arg_name = NULL, int arg = 0);
+    // Writes currently buffered events to the new numbered file next to the
+    // main trace file, without clearing the buffers
+    void WriteSnapshot();
+    // Writes the trace file and disables tracing
+    void Shutdown();
+}
+
+// Records an event lasting for the scope's lifetime
+class TraceScope
+{
+public:
+    TraceScope(const char *category, const char *name, const char *arg_name = NULL, int arg = 0)
+        : _category(category)
+        , _name(name)
+        , _argName(arg_name)
+        , _arg(arg)
+        , _enabled(Tracer::IsEnabled())
+    {
+        if (_enabled)
+            _start = AGS::Engine::GetClockMicroseconds();
+    }
+
+    ~TraceScope()
+    {
+        if (_enabled)
+            Tracer::AddEvent(_category, _name, _start, AGS::Engine::GetClockMicroseconds() - _start, _argName, _arg);
+    }
+
+private:
+    const char *_category;
+    const char *_name;
+    const char *_argName;
+    int         _arg;
+    bool        _enabled;
+    int64_t     _start;
+};
+
+#endif // __AGS_EE_DEBUG__TRACER_H
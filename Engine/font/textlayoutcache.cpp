@@ -0,0 +1,127 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include <string.h>
+#include <vector>
+#include "font/textlayoutcache.h"
+#include "gui/guidefines.h"
+#include "util/string.h"
+
+using AGS::Common::String;
+
+extern char lines[MAXLINE][200];
+extern int  numlines;
+extern int  longestline;
+
+// Number of remembered layouts
+const int TEXT_LAYOUT_CACHE_SIZE = 64;
+
+struct TextLayout
+{
+    unsigned int        Hash;
+    int                 Font;
+    int                 Width;
+    String              Text;
+    std::vector<String> Lines;
+    int                 LongestLine;
+    unsigned int        LastUsed;   // for dropping least recently used layout
+    bool                Valid;
+};
+
+TextLayout   text_layouts[TEXT_LAYOUT_CACHE_SIZE];
+unsigned int text_layout_use_counter = 0;
+
+unsigned int hash_text(const char *text)
+{
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (; *text; ++text)
+        hash = (hash ^ (unsigned char)*text) * 16777619u;
+    return hash;
+}
+
+TextLayout *find_text_layout(unsigned int hash, const char *text, int font, int width)
+{
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; ++i)
+    {
+        TextLayout &layout = text_layouts[i];
+        if (layout.Valid && layout.Hash == hash && layout.Font == font && layout.Width == width &&
+            strcmp(layout.Text.GetCStr(), text) == 0)
+            return &layout;
+    }
+    return NULL;
+}
+
+bool get_cached_text_layout(const char *text, int font, int width)
+{
+    TextLayout *layout = find_text_layout(hash_text(text), text, font, width);
+    if (!layout)
+        return false;
+
+    layout->LastUsed = ++text_layout_use_counter;
+    numlines = (int)layout->Lines.size();
+    for (int i = 0; i < numlines; ++i)
+        strcpy(lines[i], layout->Lines[i].GetCStr());
+    longestline = layout->LongestLine;
+    return true;
+}
+
+void cache_text_layout(const char *text, int font, int width)
+{
+    const unsigned int hash = hash_text(text);
+    TextLayout *layout = find_text_layout(hash, text, font, width);
+    if (!layout)
+    {
+        // Take the free or the least recently used slot
+        layout = &text_layouts[0];
+        for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE && layout->Valid; ++i)
+        {
+            if (!text_layouts[i].Valid || text_layouts[i].LastUsed < layout->LastUsed)
+                layout = &text_layouts[i];
+        }
+    }
+
+    layout->Hash = hash;
+    layout->Font = font;
+    layout->Width = width;
+    layout->Text = text;
+    layout->Lines.resize(numlines);
+    for (int i = 0; i < numlines; ++i)
+        layout->Lines[i] = lines[i];
+    layout->LongestLine = longestline;
+    layout->LastUsed = ++text_layout_use_counter;
+    layout->Valid = true;
+}
+
+void invalidate_text_layout_cache()
+{
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; ++i)
+    {
+        text_layouts[i].Valid = false;
+        text_layouts[i].Text.Empty();
+        text_layouts[i].Lines.clear();
+    }
+}
+
+void invalidate_text_layout_cache(int font)
+{
+    for (int i = 0; i < TEXT_LAYOUT_CACHE_SIZE; ++i)
+    {
+        if (text_layouts[i].Font != font)
+            continue;
+        text_layouts[i].Valid = false;
+        text_layouts[i].Text.Empty();
+        text_layouts[i].Lines.clear();
+    }
+}
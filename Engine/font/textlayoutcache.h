@@ -0,0 +1,38 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Cache of the text split into lines.
+//
+// Splitting the text measures it many times over, while labels, speech and
+// dialog options keep splitting same strings on each redraw. The cache keeps
+// the results of break_up_text_into_lines for recently used texts, keyed by
+// the text, font and width.
+//
+//=============================================================================
+#ifndef __AGS_EE_FONT__TEXTLAYOUTCACHE_H
+#define __AGS_EE_FONT__TEXTLAYOUTCACHE_H
+
+// Looks for the layout of the given text; if found, puts it into the global
+// lines array and sets numlines and longestline
+bool get_cached_text_layout(const char *text, int font, int width);
+// Remembers the contents of the global lines array as the layout of the text
+void cache_text_layout(const char *text, int font, int width);
+// Forgets all the layouts; must be called whenever fonts or the
+// translation are changed
+void invalidate_text_layout_cache();
+// Forgets the layouts made with the given font; must be called whenever
+// the font's renderer is replaced
+void invalidate_text_layout_cache(int font);
+
+#endif // __AGS_EE_FONT__TEXTLAYOUTCACHE_H
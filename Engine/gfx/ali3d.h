@@ -50,5 +50,8 @@ public:
 extern IGraphicsDriver* GetOGLGraphicsDriver(GFXFilter *);
 extern IGraphicsDriver* GetD3DGraphicsDriver(GFXFilter *);
 extern IGraphicsDriver* GetSoftwareGraphicsDriver(GFXFilter *);
+// Creates a headless driver which renders to memory; optionally saves every
+// dumpInterval-th frame as image into dumpDir, and per-frame timings to timingFile
+extern IGraphicsDriver* GetNullGraphicsDriver(GFXFilter *, int dumpInterval, const char *dumpDir, const char *timingFile);
 
 #endif
@@ -19,14 +19,20 @@
 #include <allegro.h>
 #include <stdio.h>
 #include "gfx/ali3d.h"
+#include "debug/out.h"
 #include "platform/base/agsplatformdriver.h"
 #include "gfx/bitmap.h"
 #include "gfx/ddb.h"
 #include "gfx/gfx_util.h"
 #include "gfx/graphicsdriver.h"
 #include "main/main_allegro.h"
+#include "util/clock.h"
+#include "util/file.h"
+#include "util/textstreamwriter.h"
 
 using AGS::Common::Bitmap;
+using AGS::Common::String;
+using AGS::Common::TextStreamWriter;
 namespace BitmapHelper = AGS::Common::BitmapHelper;
 using namespace AGS; // FIXME later
 
@@ -218,7 +224,7 @@ public:
 
   AllegroGFXFilter *_filter;
 
-private:
+protected:
   volatile int* _loopTimer;
   int _screenWidth, _screenHeight;
   int actualInitWid, actualInitHit;
@@ -850,3 +856,153 @@ IGraphicsDriver* GetSoftwareGraphicsDriver(GFXFilter *filter)
   return _alsoftware_driver;
 }
 
+
+
+// Null graphics driver: runs the complete software rendering pipeline,
+// including the graphics filter, on a memory bitmap that is never
+// presented. Used for benchmarking and running the engine headless.
+class NullGraphicsDriver : public ALSoftwareGraphicsDriver
+{
+public:
+  NullGraphicsDriver(AllegroGFXFilter *filter, int dumpInterval, const String &dumpDir, const String &timingFile)
+    : ALSoftwareGraphicsDriver(filter)
+    , _dumpInterval(dumpInterval)
+    , _dumpDir(dumpDir)
+    , _timingFile(timingFile)
+  {
+    _timingWriter = NULL;
+    ResetFrameStats();
+  }
+
+  virtual const char*GetDriverName() { return "Null (headless)"; }
+  virtual const char*GetDriverID() { return "NULL"; }
+  virtual bool Init(int virtualWidth, int virtualHeight, int realWidth, int realHeight, int colourDepth, bool windowed, volatile int *loopTimer);
+  virtual IGfxModeList *GetSupportedModeList(int color_depth) { return NULL; }
+  virtual void UnInit();
+  virtual void Render(GlobalFlipType flip);
+  virtual void Render() { Render(None); }
+  virtual bool PlayVideo(const char *filename, bool useAVISound, VideoSkipType skipType, bool stretchToFullScreen) { return false; }
+  virtual bool SupportsGammaControl() { return false; }
+  virtual void SetGamma(int newGamma) { }
+  virtual void Vsync() { }
+  virtual ~NullGraphicsDriver();
+
+private:
+  void ResetFrameStats();
+  void DumpFrame();
+
+  int     _dumpInterval;
+  String  _dumpDir;
+  String  _timingFile;
+  TextStreamWriter *_timingWriter;
+
+  int     _frameCount;
+  int64_t _lastFrameStart;
+  int64_t _renderTimeTotal;
+  int64_t _renderTimeMin;
+  int64_t _renderTimeMax;
+};
+
+NullGraphicsDriver::~NullGraphicsDriver()
+{
+  delete _timingWriter;
+}
+
+bool NullGraphicsDriver::Init(int virtualWidth, int virtualHeight, int realWidth, int realHeight, int colourDepth, bool windowed, volatile int *loopTimer)
+{
+  _screenWidth = virtualWidth;
+  _screenHeight = virtualHeight;
+  _colorDepth = colourDepth;
+  _windowed = windowed;
+  _loopTimer = loopTimer;
+
+  set_color_depth(colourDepth);
+  actualInitWid = realWidth, actualInitHit = realHeight;
+
+  if (_initGfxCallback != NULL)
+    _initGfxCallback(NULL);
+
+  // Instead of setting the display mode, create a memory bitmap to serve
+  // as the "real" screen; the filter will render the final image into it
+  _allegroScreenWrapper = BitmapHelper::CreateBitmap(actualInitWid, actualInitHit, colourDepth);
+  if (_allegroScreenWrapper == NULL)
+  {
+    set_allegro_error("Failed to create memory screen");
+    return false;
+  }
+  _allegroScreenWrapper->Clear();
+  BitmapHelper::SetScreenBitmap( _filter->ScreenInitialized(_allegroScreenWrapper, _screenWidth, _screenHeight) );
+  virtualScreen = BitmapHelper::GetScreenBitmap();
+
+  if (!_timingFile.IsEmpty())
+  {
+    Common::Stream *out = Common::File::CreateFile(_timingFile);
+    if (out)
+    {
+      _timingWriter = new TextStreamWriter(out);
+      _timingWriter->WriteLine("frame,render_us,interval_us");
+    }
+  }
+  ResetFrameStats();
+  return true;
+}
+
+void NullGraphicsDriver::UnInit()
+{
+  if (_frameCount > 0)
+  {
+    AGS::Common::Out::FPrint("Null gfx driver: rendered %d frames, render time (us): avg %d, min %d, max %d",
+      _frameCount, (int)(_renderTimeTotal / _frameCount), (int)_renderTimeMin, (int)_renderTimeMax);
+  }
+  delete _timingWriter;
+  _timingWriter = NULL;
+
+  // The base implementation shuts down the filter and deletes our memory
+  // screen along with the "wrapper"
+  ALSoftwareGraphicsDriver::UnInit();
+}
+
+void NullGraphicsDriver::ResetFrameStats()
+{
+  _frameCount = 0;
+  _lastFrameStart = 0;
+  _renderTimeTotal = 0;
+  _renderTimeMin = 0;
+  _renderTimeMax = 0;
+}
+
+void NullGraphicsDriver::Render(GlobalFlipType flip)
+{
+  const int64_t frameStart = AGS::Engine::GetClockMicroseconds();
+  ALSoftwareGraphicsDriver::Render(flip);
+  const int64_t renderTime = AGS::Engine::GetClockMicroseconds() - frameStart;
+  const int64_t interval = _frameCount > 0 ? frameStart - _lastFrameStart : 0;
+
+  _renderTimeTotal += renderTime;
+  if (_frameCount == 0 || renderTime < _renderTimeMin)
+    _renderTimeMin = renderTime;
+  if (renderTime > _renderTimeMax)
+    _renderTimeMax = renderTime;
+  _lastFrameStart = frameStart;
+  _frameCount++;
+
+  if (_timingWriter)
+    _timingWriter->WriteFormat("%d,%d,%d\n", _frameCount, (int)renderTime, (int)interval);
+  if (_dumpInterval > 0 && (_frameCount % _dumpInterval) == 0)
+    DumpFrame();
+}
+
+void NullGraphicsDriver::DumpFrame()
+{
+  String filename = String::FromFormat("%s/frame%06d.bmp",
+    _dumpDir.IsEmpty() ? "." : _dumpDir.GetCStr(), _frameCount);
+  PALETTE pal;
+  get_palette(pal);
+  if (!_allegroScreenWrapper->SaveToFile(filename, pal))
+    AGS::Common::Out::FPrint("Null gfx driver: failed to write %s", filename.GetCStr());
+}
+
+IGraphicsDriver* GetNullGraphicsDriver(GFXFilter *filter, int dumpInterval, const char *dumpDir, const char *timingFile)
+{
+  return new NullGraphicsDriver((AllegroGFXFilter*)filter, dumpInterval, dumpDir, timingFile);
+}
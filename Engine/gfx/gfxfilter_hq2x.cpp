@@ -16,6 +16,7 @@
 #include "gfx/gfxfilter_hq2x.h"
 #include "gfx/hq2x3x.h"
 #include "gfx/gfxfilterdefines.h"
+#include "gfx/rowworkers.h"
 
 using AGS::Common::Bitmap;
 namespace BitmapHelper = AGS::Common::BitmapHelper;
@@ -44,14 +45,37 @@ Bitmap *Hq2xGFXFilter::ShutdownAndReturnRealScreen(Bitmap *currentScreen) {
     return realScreen;
 }
 
+void hq2x_band(void *data, int from_row, int to_row) {
+    HqScalingJob *job = (HqScalingJob*)data;
+    hq2x_32_rows(job->In, job->InBpL, job->Out, job->OutBpL, job->Width, job->Height, from_row, to_row);
+}
+
 void Hq2xGFXFilter::RenderScreen(Bitmap *toRender, int x, int y) {
 
-    realScreenBuffer->Acquire();
-    hq2x_32(&toRender->GetScanLineForWriting(0)[0], &realScreenBuffer->GetScanLineForWriting(0)[0], toRender->GetWidth(), toRender->GetHeight(), realScreenBuffer->GetWidth() * BYTES_PER_PIXEL(realScreenBuffer->GetColorDepth()));
-    realScreenBuffer->Release();
+    const int width = toRender->GetWidth();
+    const int height = toRender->GetHeight();
+    // Scale straight into the real screen if it is a plain memory bitmap,
+    // otherwise scale into the buffer and blit it to the screen
+    const bool direct = realScreen->IsMemoryBitmap() && realScreen->GetColorDepth() == 32 &&
+        x >= 0 && y >= 0 && (x + width) * MULTIPLIER <= realScreen->GetWidth() &&
+        (y + height) * MULTIPLIER <= realScreen->GetHeight();
+    Bitmap *dest = direct ? realScreen : realScreenBuffer;
+
+    HqScalingJob job;
+    job.In = toRender->GetScanLine(0);
+    job.InBpL = height > 1 ? toRender->GetScanLine(1) - toRender->GetScanLine(0) : toRender->GetLineLength();
+    job.Out = dest->GetScanLineForWriting(direct ? y * MULTIPLIER : 0) + (direct ? x * MULTIPLIER * 4 : 0);
+    job.OutBpL = dest->GetScanLine(1) - dest->GetScanLine(0);
+    job.Width = width;
+    job.Height = height;
+
+    dest->Acquire();
+    run_row_bands(hq2x_band, &job, height);
+    dest->Release();
 
-    realScreen->Blit(realScreenBuffer, 0, 0, x * MULTIPLIER, y * MULTIPLIER,
-        toRender->GetWidth() * MULTIPLIER, toRender->GetHeight() * MULTIPLIER);
+    if (!direct)
+        realScreen->Blit(realScreenBuffer, 0, 0, x * MULTIPLIER, y * MULTIPLIER,
+            width * MULTIPLIER, height * MULTIPLIER);
 
     lastBlitFrom = toRender;
 }
@@ -19,10 +19,31 @@
 void InitLUTs(){}
 void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL ){}
 void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL ){}
+void hq2x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow ){}
+void hq3x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow ){}
 #else
 void InitLUTs();
 void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL );
 void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL );
+// Scale only the source rows in range [FromRow, ToRow); pIn and pOut point to
+// the beginning of the whole images, InBpL and BpL are their line pitches
+void hq2x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow );
+void hq3x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow );
 #endif
 
+// Arguments for scaling the image in bands, see run_row_bands()
+struct HqScalingJob
+{
+    const unsigned char *In;
+    int                  InBpL;
+    unsigned char       *Out;
+    int                  OutBpL;
+    int                  Width;
+    int                  Height;
+};
+
 #endif // __AC_HQ2X3X_H
\ No newline at end of file
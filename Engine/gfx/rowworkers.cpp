@@ -0,0 +1,162 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "gfx/rowworkers.h"
+
+#if defined(WINDOWS_VERSION) || defined(LINUX_VERSION) || defined(MAC_VERSION) || \
+    defined(IOS_VERSION) || defined(ANDROID_VERSION)
+#define AGS_HAS_ROW_WORKERS
+#endif
+
+#if defined(AGS_HAS_ROW_WORKERS)
+
+#include "debug/out.h"
+#include "util/semaphore.h"
+#include "util/thread.h"
+#if !defined(WINDOWS_VERSION)
+#include <unistd.h>
+#endif
+
+using AGS::Engine::Semaphore;
+using AGS::Engine::Thread;
+namespace Out = AGS::Common::Out;
+
+// Maximal number of worker threads; the calling thread runs a band too
+const int MAX_ROW_WORKERS = 3;
+// Don't split images into bands smaller than this
+const int MIN_BAND_ROWS = 16;
+
+struct RowWorker
+{
+    Thread    WorkThread;
+    Semaphore Start;
+    int       FromRow;
+    int       ToRow;
+};
+
+RowWorker    row_workers[MAX_ROW_WORKERS];
+int          num_row_workers = -1; // -1 means not initialized yet
+volatile bool row_workers_quit = false;
+Semaphore    row_workers_done;
+RowBandProc  row_job_proc;
+void        *row_job_data;
+
+int get_cpu_count()
+{
+#if defined(WINDOWS_VERSION)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors;
+#else
+    return sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
+void run_row_worker(int index)
+{
+    // The thread entry is called repeatedly until the thread is stopped
+    if (row_workers_quit)
+        return;
+    RowWorker &worker = row_workers[index];
+    worker.Start.Wait();
+    if (row_workers_quit)
+        return;
+    row_job_proc(row_job_data, worker.FromRow, worker.ToRow);
+    row_workers_done.Post();
+}
+
+// Thread entry functions take no arguments, so there is one per worker
+template <int Index> void row_worker_entry()
+{
+    run_row_worker(Index);
+}
+
+const AGS::Engine::BaseThread::AGSThreadEntry row_worker_entries[MAX_ROW_WORKERS] =
+{
+    row_worker_entry<0>, row_worker_entry<1>, row_worker_entry<2>
+};
+
+void init_row_workers()
+{
+    int count = get_cpu_count() - 1;
+    if (count > MAX_ROW_WORKERS)
+        count = MAX_ROW_WORKERS;
+    row_workers_quit = false;
+    num_row_workers = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (!row_workers[i].WorkThread.CreateAndStart(row_worker_entries[i], true))
+            break;
+        num_row_workers++;
+    }
+    Out::FPrint("Started %d worker thread(s) for graphics filters", num_row_workers);
+}
+
+void run_row_bands(RowBandProc proc, void *data, int rows)
+{
+    if (num_row_workers < 0)
+        init_row_workers();
+
+    int bands = num_row_workers + 1;
+    if (rows / bands < MIN_BAND_ROWS)
+        bands = rows / MIN_BAND_ROWS;
+    if (bands <= 1)
+    {
+        proc(data, 0, rows);
+        return;
+    }
+
+    row_job_proc = proc;
+    row_job_data = data;
+    // The calling thread takes the first band
+    const int band_rows = rows / bands;
+    for (int i = 1; i < bands; ++i)
+    {
+        RowWorker &worker = row_workers[i - 1];
+        worker.FromRow = band_rows * i;
+        worker.ToRow = i < bands - 1 ? band_rows * (i + 1) : rows;
+        worker.Start.Post();
+    }
+    proc(data, 0, band_rows);
+    for (int i = 1; i < bands; ++i)
+        row_workers_done.Wait();
+}
+
+void shutdown_row_workers()
+{
+    if (num_row_workers <= 0)
+    {
+        num_row_workers = 0;
+        return;
+    }
+    row_workers_quit = true;
+    for (int i = 0; i < num_row_workers; ++i)
+        row_workers[i].Start.Post();
+    for (int i = 0; i < num_row_workers; ++i)
+        row_workers[i].WorkThread.Stop();
+    num_row_workers = 0;
+}
+
+#else // !AGS_HAS_ROW_WORKERS
+
+void run_row_bands(RowBandProc proc, void *data, int rows)
+{
+    proc(data, 0, rows);
+}
+
+void shutdown_row_workers()
+{
+}
+
+#endif // AGS_HAS_ROW_WORKERS
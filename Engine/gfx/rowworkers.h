@@ -0,0 +1,31 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Worker threads for processing an image in horizontal bands in parallel.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__ROWWORKERS_H
+#define __AGS_EE_GFX__ROWWORKERS_H
+
+// Processes rows in range [from_row, to_row)
+typedef void (*RowBandProc)(void *data, int from_row, int to_row);
+
+// Splits rows into bands and runs the procedure for each of them, using
+// worker threads where available; returns when all the bands are done.
+// Procedure must be safe to run for the different bands simultaneously.
+void run_row_bands(RowBandProc proc, void *data, int rows);
+// Stops worker threads; any later work is done on the calling thread
+void shutdown_row_workers();
+
+#endif // __AGS_EE_GFX__ROWWORKERS_H
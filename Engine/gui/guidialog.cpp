@@ -15,6 +15,7 @@
 #include <stdio.h>
 #include "gui/guidialog.h"
 #include "gfx/ali3d.h"
+#include "ac/asyncsave.h"
 #include "ac/common.h"
 #include "ac/draw.h"
 #include "ac/game.h"
@@ -257,6 +258,8 @@ int savegamedialog()
 
 void preparesavegamelist(int ctrllist)
 {
+  // make sure that the game being saved is in the list
+  wait_for_async_save();
   numsaves = 0;
   toomanygames = 0;
   al_ffblk ffb;
@@ -19,9 +19,13 @@
 #include <stdlib.h>
 #include "core/types.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HQ_USE_SSE2
+#endif
+
 static int   LUT16to32[65536];
 static int   RGBtoYUV[65536];
-static int   YUV1, YUV2;
 const  int   Ymask = 0x00FF0000;
 const  int   Umask = 0x0000FF00;
 const  int   Vmask = 0x000000FF;
@@ -146,8 +150,9 @@ inline void Interp10(unsigned char * pc, int c1, int c2, int c3)
 
 inline bool Diff(unsigned int w1, unsigned int w2)
 {
-  YUV1 = RGBtoYUV[w1];
-  YUV2 = RGBtoYUV[w2];
+  // [AGS] local variables, so that the bands may be processed by several threads
+  const int YUV1 = RGBtoYUV[w1];
+  const int YUV2 = RGBtoYUV[w2];
   return ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
            ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
            ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) );
@@ -156,10 +161,147 @@ inline bool Diff(unsigned int w1, unsigned int w2)
 #define INPUT_IMAGE_PIXEL_SIZE uint32_t
 #define INPUT_IMAGE_PIXEL_SIZE_IN_BYTES sizeof(INPUT_IMAGE_PIXEL_SIZE)
 
+void hq2x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow );
+void hq3x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow );
+
+// [AGS] Each source row is converted to 16-bit and looked up in the tables only
+// once, instead of once per every neighbour; the rows are padded with a copy of
+// the edge pixel on both sides, so that neighbours may be accessed without checks.
+struct HqRow
+{
+  int  Row;
+  int *W16; // 16-bit colour
+  int *YUV; // RGBtoYUV of the colour
+  int *RGB; // LUT16to32 of the colour
+};
+
+class HqRowCache
+{
+public:
+  HqRowCache(const unsigned char *pIn, int InBpL, int Xres, int Yres)
+    : _in(pIn), _inBpL(InBpL), _xres(Xres), _yres(Yres)
+  {
+    const int stride = Xres + 2;
+    _data = new int[stride * 3 * 3];
+    for (int k = 0; k < 3; k++)
+    {
+      _rows[k].Row = -1;
+      _rows[k].W16 = _data + stride * (k * 3);
+      _rows[k].YUV = _data + stride * (k * 3 + 1);
+      _rows[k].RGB = _data + stride * (k * 3 + 2);
+    }
+  }
+
+  ~HqRowCache()
+  {
+    delete [] _data;
+  }
+
+  // Gets the row, clamped to the image bounds
+  const HqRow &GetRow(int row)
+  {
+    if (row < 0)
+      row = 0;
+    else if (row >= _yres)
+      row = _yres - 1;
+    HqRow &r = _rows[row % 3];
+    if (r.Row != row)
+      ConvertRow(r, row);
+    return r;
+  }
+
+private:
+  void ConvertRow(HqRow &r, int row)
+  {
+    const INPUT_IMAGE_PIXEL_SIZE *src = (const INPUT_IMAGE_PIXEL_SIZE*)(_in + row * _inBpL);
+    for (int i = 0; i < _xres; i++)
+    {
+      const int w = src[i];
+      // convert down to 16-bit
+      const int w16 = (((((w >> 16) & 0x00ff) / 8) << 11) +
+          ((((w >> 8) & 0x00ff) / 4) << 5) +
+          ((w  & 0x00ff) / 8)) & 0x000ffff;
+      r.W16[i + 1] = w16;
+      r.YUV[i + 1] = RGBtoYUV[w16];
+      r.RGB[i + 1] = LUT16to32[w16];
+    }
+    r.W16[0] = r.W16[1];
+    r.YUV[0] = r.YUV[1];
+    r.RGB[0] = r.RGB[1];
+    r.W16[_xres + 1] = r.W16[_xres];
+    r.YUV[_xres + 1] = r.YUV[_xres];
+    r.RGB[_xres + 1] = r.RGB[_xres];
+    r.Row = row;
+  }
+
+  const unsigned char *_in;
+  int   _inBpL;
+  int   _xres;
+  int   _yres;
+  int  *_data;
+  HqRow _rows[3];
+};
+
+// [AGS] Gets the pattern of the neighbours w1-w4, w6-w9 (bits 0-7) which colour
+// differs noticeably from w5, for the pixel at padded position x
+#if defined(HQ_USE_SSE2)
+inline int GetPattern(const HqRow &r1, const HqRow &r2, const HqRow &r3, int x)
+{
+  // YUV values have one component per byte, so the thresholds may be tested
+  // for all of them at once: |a - b| = sat(a - b) | sat(b - a)
+  const __m128i zero   = _mm_setzero_si128();
+  const __m128i thr    = _mm_set1_epi32(trY | trU | trV);
+  const __m128i center = _mm_set1_epi32(r2.YUV[x]);
+  const __m128i lo = _mm_set_epi32(r2.YUV[x - 1], r1.YUV[x + 1], r1.YUV[x], r1.YUV[x - 1]);
+  const __m128i hi = _mm_set_epi32(r3.YUV[x + 1], r3.YUV[x], r3.YUV[x - 1], r2.YUV[x + 1]);
+  const __m128i dlo = _mm_or_si128(_mm_subs_epu8(lo, center), _mm_subs_epu8(center, lo));
+  const __m128i dhi = _mm_or_si128(_mm_subs_epu8(hi, center), _mm_subs_epu8(center, hi));
+  // lanes with all components within threshold become all ones
+  const __m128i slo = _mm_cmpeq_epi32(_mm_subs_epu8(dlo, thr), zero);
+  const __m128i shi = _mm_cmpeq_epi32(_mm_subs_epu8(dhi, thr), zero);
+  const int same = _mm_movemask_ps(_mm_castsi128_ps(slo)) | (_mm_movemask_ps(_mm_castsi128_ps(shi)) << 4);
+  return ~same & 0xFF;
+}
+#else
+inline int GetPattern(const HqRow &r1, const HqRow &r2, const HqRow &r3, int x)
+{
+  const int YUV1 = r2.YUV[x];
+  const int YUV2[8] = { r1.YUV[x - 1], r1.YUV[x], r1.YUV[x + 1], r2.YUV[x - 1],
+                        r2.YUV[x + 1], r3.YUV[x - 1], r3.YUV[x], r3.YUV[x + 1] };
+  int pattern = 0;
+  for (int k = 0; k < 8; k++)
+  {
+    if ( ( abs((YUV1 & Ymask) - (YUV2[k] & Ymask)) > trY ) ||
+         ( abs((YUV1 & Umask) - (YUV2[k] & Umask)) > trU ) ||
+         ( abs((YUV1 & Vmask) - (YUV2[k] & Vmask)) > trV ) )
+      pattern |= 1 << k;
+  }
+  return pattern;
+}
+#endif
+
+// [AGS] Fills the neighbourhood of the pixel at padded position x
+inline void GetNeighbours(const HqRow &r1, const HqRow &r2, const HqRow &r3, int x, int *w, int *c)
+{
+  w[1] = r1.W16[x - 1]; w[2] = r1.W16[x]; w[3] = r1.W16[x + 1];
+  w[4] = r2.W16[x - 1]; w[5] = r2.W16[x]; w[6] = r2.W16[x + 1];
+  w[7] = r3.W16[x - 1]; w[8] = r3.W16[x]; w[9] = r3.W16[x + 1];
+  c[1] = r1.RGB[x - 1]; c[2] = r1.RGB[x]; c[3] = r1.RGB[x + 1];
+  c[4] = r2.RGB[x - 1]; c[5] = r2.RGB[x]; c[6] = r2.RGB[x + 1];
+  c[7] = r3.RGB[x - 1]; c[8] = r3.RGB[x]; c[9] = r3.RGB[x + 1];
+}
+
 void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL )
 {
-  int  i, j, k;
-  int  prevline, nextline;
+  hq2x_32_rows(pIn, Xres * INPUT_IMAGE_PIXEL_SIZE_IN_BYTES, pOut, BpL, Xres, Yres, 0, Yres);
+}
+
+void hq2x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow )
+{
+  int  i, j;
   int  w[10];
   int  c[10];
 
@@ -174,72 +316,19 @@ void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
   //   | w7 | w8 | w9 |
   //   +----+----+----+
 
-  for (j=0; j<Yres; j++)
+  HqRowCache cache(pIn, InBpL, Xres, Yres);
+  pOut += FromRow * 2 * BpL;
+
+  for (j=FromRow; j<ToRow; j++)
   {
-    if (j>0)      prevline = -Xres*4; else prevline = 0;
-    if (j<Yres-1) nextline =  Xres*4; else nextline = 0;
+    const HqRow &r1 = cache.GetRow(j - 1);
+    const HqRow &r2 = cache.GetRow(j);
+    const HqRow &r3 = cache.GetRow(j + 1);
 
     for (i=0; i<Xres; i++)
     {
-      w[2] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + prevline));
-      w[5] = *((INPUT_IMAGE_PIXEL_SIZE*)pIn);
-      w[8] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + nextline));
-
-      if (i>0)
-      {
-        w[1] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + prevline - INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[4] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn - INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[7] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + nextline - INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-      }
-      else
-      {
-        w[1] = w[2];
-        w[4] = w[5];
-        w[7] = w[8];
-      }
-
-      if (i<Xres-1)
-      {
-        w[3] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + prevline + INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[6] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[9] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + nextline + INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-      }
-      else
-      {
-        w[3] = w[2];
-        w[6] = w[5];
-        w[9] = w[8];
-      }
-
-      // convert down to 16-bit
-      for (k = 1; k <= 9; k++) {
-        w[k] = (((((w[k] >> 16) & 0x00ff) / 8) << 11) +
-          ((((w[k] >> 8) & 0x00ff) / 4) << 5) +
-          ((w[k]  & 0x00ff) / 8)) & 0x000ffff;
-      }
-
-      int pattern = 0;
-      int flag = 1;
-
-      YUV1 = RGBtoYUV[w[5]];
-
-      for (k=1; k<=9; k++)
-      {
-        if (k==5) continue;
-
-        if ( w[k] != w[5] )
-        {
-          YUV2 = RGBtoYUV[w[k]];
-          if ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
-               ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
-               ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
-            pattern |= flag;
-        }
-        flag <<= 1;
-      }
-
-      for (k=1; k<=9; k++)
-        c[k] = LUT16to32[w[k]];
+      const int pattern = GetPattern(r1, r2, r3, i + 1);
+      GetNeighbours(r1, r2, r3, i + 1, w, c);
 
       switch (pattern)
       {
@@ -2883,7 +2972,6 @@ void hq2x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
           break;
         }
       }
-      pIn += INPUT_IMAGE_PIXEL_SIZE_IN_BYTES;
       pOut+=8;
     }
     pOut+=BpL + (BpL - Xres * 8);
@@ -2974,8 +3062,13 @@ void InitLUTs(void)
 
 void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int BpL )
 {
-  int  i, j, k;
-  int  prevline, nextline;
+  hq3x_32_rows(pIn, Xres * INPUT_IMAGE_PIXEL_SIZE_IN_BYTES, pOut, BpL, Xres, Yres, 0, Yres);
+}
+
+void hq3x_32_rows( const unsigned char * pIn, int InBpL, unsigned char * pOut, int BpL,
+                   int Xres, int Yres, int FromRow, int ToRow )
+{
+  int  i, j;
   int  w[10];
   int  c[10];
 
@@ -2990,72 +3083,19 @@ void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
   //   | w7 | w8 | w9 |
   //   +----+----+----+
 
-  for (j=0; j<Yres; j++)
+  HqRowCache cache(pIn, InBpL, Xres, Yres);
+  pOut += FromRow * 3 * BpL;
+
+  for (j=FromRow; j<ToRow; j++)
   {
-    if (j>0)      prevline = -Xres*4; else prevline = 0;
-    if (j<Yres-1) nextline =  Xres*4; else nextline = 0;
+    const HqRow &r1 = cache.GetRow(j - 1);
+    const HqRow &r2 = cache.GetRow(j);
+    const HqRow &r3 = cache.GetRow(j + 1);
 
     for (i=0; i<Xres; i++)
     {
-      w[2] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + prevline));
-      w[5] = *((INPUT_IMAGE_PIXEL_SIZE*)pIn);
-      w[8] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + nextline));
-
-      if (i>0)
-      {
-        w[1] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + prevline - INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[4] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn - INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[7] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + nextline - INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-      }
-      else
-      {
-        w[1] = w[2];
-        w[4] = w[5];
-        w[7] = w[8];
-      }
-
-      if (i<Xres-1)
-      {
-        w[3] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + prevline + INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[6] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-        w[9] = *((INPUT_IMAGE_PIXEL_SIZE*)(pIn + nextline + INPUT_IMAGE_PIXEL_SIZE_IN_BYTES));
-      }
-      else
-      {
-        w[3] = w[2];
-        w[6] = w[5];
-        w[9] = w[8];
-      }
-
-      // convert down to 16-bit
-      for (k = 1; k <= 9; k++) {
-        w[k] = (((((w[k] >> 16) & 0x00ff) / 8) << 11) +
-          ((((w[k] >> 8) & 0x00ff) / 4) << 5) +
-          ((w[k]  & 0x00ff) / 8)) & 0x000ffff;
-      }
-
-      int pattern = 0;
-      int flag = 1;
-
-      YUV1 = RGBtoYUV[w[5]];
-
-      for (k=1; k<=9; k++)
-      {
-        if (k==5) continue;
-
-        if ( w[k] != w[5] )
-        {
-          YUV2 = RGBtoYUV[w[k]];
-          if ( ( abs((YUV1 & Ymask) - (YUV2 & Ymask)) > trY ) ||
-               ( abs((YUV1 & Umask) - (YUV2 & Umask)) > trU ) ||
-               ( abs((YUV1 & Vmask) - (YUV2 & Vmask)) > trV ) )
-            pattern |= flag;
-        }
-        flag <<= 1;
-      }
-
-      for (k=1; k<=9; k++)
-        c[k] = LUT16to32[w[k]];
+      const int pattern = GetPattern(r1, r2, r3, i + 1);
+      GetNeighbours(r1, r2, r3, i + 1, w, c);
 
       switch (pattern)
       {
@@ -6672,7 +6712,6 @@ void hq3x_32( unsigned char * pIn, unsigned char * pOut, int Xres, int Yres, int
           break;
         }
       }
-      pIn += INPUT_IMAGE_PIXEL_SIZE_IN_BYTES;
       pOut+=12;
     }
     pOut+=BpL + (BpL - Xres * 12);
@@ -21,13 +21,16 @@
 #include "ac/gamestate.h"
 #include "debug/debug_log.h"
 #include "main/mainheader.h"
+#include "main/main.h"
 #include "main/config.h"
+#include "media/audio/nullsounddriver.h"
 #include "ac/spritecache.h"
 #include "platform/base/agsplatformdriver.h"
 #include "platform/base/override_defines.h" //_getcwd()
 #include "util/directory.h"
 #include "util/filestream.h"
 #include "util/ini_util.h"
+#include "util/math.h"
 #include "util/textstreamreader.h"
 #include "util/path.h"
 
@@ -44,6 +47,7 @@ extern int psp_ignore_acsetup_cfg_file;
 extern int psp_clear_cache_on_room_change;
 extern int psp_midi_preload_patches;
 extern int psp_audio_cachesize;
+extern int audio_stream_buffer_size;
 extern char psp_game_file_name[];
 extern int psp_gfx_smooth_sprites;
 extern char psp_translation[];
@@ -198,6 +202,9 @@ void read_config(const ConfigTree &cfg)
         if (usetup.midicard < 0)
             usetup.midicard = MIDI_AUTODETECT;
 #endif
+        // The headless driver is chosen by name, since its ID is not a card index
+        if (INIreadstring(cfg, "sound", "driver", "").CompareNoCase("NULL") == 0)
+            usetup.digicard = DIGI_AGS_NULL;
 
 #if !defined (LINUX_VERSION)
         int threaded_audio = INIreadint(cfg, "sound", "threaded");
@@ -205,6 +212,53 @@ void read_config(const ConfigTree &cfg)
             psp_audio_multithreaded = threaded_audio;
 #endif
 
+        // Playing time of the decoding buffers, converted to their size in bytes
+        // for 44.1 kHz 16-bit stereo; the decoders need room for at least one
+        // MP3 frame (1152 stereo samples), and alogg refuses less than 4 KB
+        int stream_buffer_ms = INIreadint(cfg, "sound", "stream_buffer_ms");
+        if (stream_buffer_ms > 0)
+        {
+            stream_buffer_ms = AGS::Common::Math::Min(stream_buffer_ms, 2000);
+            audio_stream_buffer_size = (stream_buffer_ms * 44100 * 2 * 2 / 1000 + 255) & ~255;
+            audio_stream_buffer_size = AGS::Common::Math::Max(audio_stream_buffer_size, 4608);
+        }
+
+        // Loading clips in background, optionally only the clips of listed audio types
+        if (INIreadint(cfg, "sound", "async_load") > 0)
+        {
+            String types_str = INIreadstring(cfg, "sound", "async_load_types", "");
+            if (types_str.IsEmpty())
+            {
+                usetup.async_audio_types = -1;
+            }
+            else
+            {
+                usetup.async_audio_types = 0;
+                const char *p = types_str.GetCStr();
+                while (*p)
+                {
+                    char *end;
+                    long type = strtol(p, &end, 10);
+                    if (end == p)
+                    {
+                        p++;
+                        continue;
+                    }
+                    if ((type >= 0) && (type < MAX_AUDIO_TYPES))
+                        usetup.async_audio_types |= (1 << type);
+                    p = end;
+                }
+            }
+        }
+
+        // Decoded sound cache budget in kilobytes, and the longest clip to put there
+        int decoded_cache_kb = INIreadint(cfg, "sound", "decoded_cache_size");
+        if (decoded_cache_kb >= 0)
+            usetup.decoded_sound_cache_size = AGS::Common::Math::Min(decoded_cache_kb, 1024 * 1024) * 1024;
+        int decoded_max_length = INIreadint(cfg, "sound", "decoded_cache_max_length");
+        if (decoded_max_length >= 0)
+            usetup.decoded_sound_max_length = decoded_max_length;
+
         usetup.windowed = INIreadint(cfg, "misc", "windowed") > 0;
 
         usetup.refresh = INIreadint (cfg, "misc", "refresh");
@@ -250,8 +304,39 @@ void read_config(const ConfigTree &cfg)
 #if defined (WINDOWS_VERSION)
         usetup.gfxDriverID = INIreadstring(cfg, "misc", "gfxdriver");
 #else
-        usetup.gfxDriverID = "DX5";
+        usetup.gfxDriverID = INIreadstring(cfg, "misc", "gfxdriver");
+        // only the software renderer and the headless null driver are available
+        if (usetup.gfxDriverID.CompareNoCase("NULL") != 0)
+            usetup.gfxDriverID = "DX5";
 #endif
+        usetup.gfx_dump_interval = INIreadint(cfg, "misc", "gfxdump_interval");
+        usetup.gfx_dump_dir = INIreadstring(cfg, "misc", "gfxdump_dir");
+        usetup.gfx_timing_file = INIreadstring(cfg, "misc", "gfxtiming_file");
+        if (INIreadint(cfg, "misc", "frametimes") > 0)
+            usetup.frame_timing = true;
+        usetup.frame_timing_file = INIreadstring(cfg, "misc", "frametimes_file");
+        usetup.frame_timing_interval = INIreadint(cfg, "misc", "frametimes_interval");
+        usetup.trace_file = INIreadstring(cfg, "misc", "trace_file");
+
+        if (INIreadint(cfg, "misc", "async_save") == 0)
+            usetup.async_save = false;
+        int snapshot_count = INIreadint(cfg, "misc", "snapshot_count");
+        if (snapshot_count >= 0)
+            usetup.snapshot_count = snapshot_count;
+        int snapshot_interval = INIreadint(cfg, "misc", "snapshot_interval");
+        if (snapshot_interval > 0)
+            usetup.snapshot_interval = snapshot_interval;
+
+        const char *pathfinder_options[kNumPathfinderTypes] = { "legacy", "astar" };
+        String pathfinder_str = INIreadstring(cfg, "misc", "pathfinder", "legacy");
+        for (int i = 0; i < kNumPathfinderTypes; ++i)
+        {
+            if (pathfinder_str.CompareNoCase(pathfinder_options[i]) == 0)
+            {
+                usetup.pathfinder = (PathfinderType)i;
+                break;
+            }
+        }
 
         usetup.translation = INIreadstring(cfg, "language", "translation");
 
@@ -334,6 +419,9 @@ void post_config()
 {
     if (usetup.gfxDriverID.IsEmpty())
         usetup.gfxDriverID = "DX5";
+    // the command line has the last word
+    if (force_trace_file)
+        usetup.trace_file = force_trace_file;
 }
 
 void load_default_config_file(ConfigTree &cfg, const char *alt_cfg_file)
@@ -39,6 +39,8 @@
 #include "ac/dynobj/scriptsystem.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
+#include "debug/frametimer.h"
+#include "debug/tracer.h"
 #include "debug/out.h"
 #include "font/agsfontrenderer.h"
 #include "font/fonts.h"
@@ -48,6 +50,7 @@
 #include "main/engine.h"
 #include "main/main.h"
 #include "main/main_allegro.h"
+#include "media/audio/nullsounddriver.h"
 #include "media/audio/sound.h"
 #include "ac/spritecache.h"
 #include "util/filestream.h"
@@ -639,6 +642,12 @@ void engine_init_sound()
     if (!psp_midi_enabled)
         usetup.midicard = MIDI_NONE;
 
+    if ((usetup.digicard == DIGI_AGS_NULL) && !register_null_sound_driver(true))
+    {
+        Out::FPrint("Null sound driver is not supported on this platform, sound is disabled");
+        usetup.digicard = DIGI_NONE;
+    }
+
     AlIDStr digi_id;
     AlIDStr midi_id;
     AlDigiToChars(usetup.digicard, digi_id);
@@ -709,6 +718,19 @@ void engine_init_debug()
             "[Debug flags enabled: 0x%02X]\n"
             "Press a key to continue.\n",debug_flags);
     }
+
+    if (usetup.frame_timing)
+    {
+        Out::FPrint("Enable frame timing");
+        FrameTimer::Enable(true);
+        FrameTimer::SetDumpFile(usetup.frame_timing_file, usetup.frame_timing_interval);
+    }
+    if (!usetup.trace_file.IsEmpty())
+    {
+        Out::FPrint("Enable activity tracing to %s", usetup.trace_file.GetCStr());
+        Tracer::Init(usetup.trace_file);
+        Tracer::SetThreadName("main");
+    }
 }
 
 void atexit_handler() {
@@ -1275,8 +1297,14 @@ void engine_init_game_shit()
 
 void engine_update_mp3_thread()
 {
-  update_mp3_thread();
-  platform->Delay(50);
+  static bool thread_named = false;
+  if (!thread_named)
+  {
+    Tracer::SetThreadName("audio");
+    thread_named = true;
+  }
+  const bool playing = update_mp3_thread();
+  wait_for_audio_thread_wakeup(playing);
 }
 
 void engine_start_multithreaded_audio()
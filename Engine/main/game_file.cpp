@@ -33,6 +33,7 @@
 #include "debug/debug_log.h"
 #include "debug/out.h"
 #include "font/fonts.h"
+#include "font/textlayoutcache.h"
 #include "gui/guilabel.h"
 #include "main/main.h"
 #include "platform/base/agsplatformdriver.h"
@@ -510,6 +511,7 @@ void init_and_register_fonts()
         if (!wloadfont_size(ee, fontsize))
             quitprintf("Unable to load font %d, no renderer could load a matching file", ee);
     }
+    invalidate_text_layout_cache();
 }
 
 void init_and_register_game_objects()
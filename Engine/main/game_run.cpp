@@ -16,6 +16,8 @@
 // Game loop
 //
 
+#include "ac/asyncsave.h"
+#include "ac/gamesnapshot.h"
 #include "ac/common.h"
 #include "ac/characterextras.h"
 #include "ac/characterinfo.h"
@@ -42,8 +44,11 @@
 #include "ac/roomobject.h"
 #include "ac/roomstatus.h"
 #include "ac/roomstruct.h"
+#include "ac/savegameindex.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
+#include "debug/frametimer.h"
+#include "debug/tracer.h"
 #include "gui/guiinv.h"
 #include "gui/guimain.h"
 #include "gui/guitextbox.h"
@@ -250,7 +255,7 @@ void check_controls() {
 
             if (mousey < guis[aa].popupyp) {
                 set_mouse_cursor(CURS_ARROW);
-                guis[aa].on=1; guis_need_update = 1;
+                guis[aa].on=1; guis[aa].mark_changed();
                 ifacepopped=aa; PauseGame();
                 break;
             }
@@ -393,6 +398,10 @@ void check_controls() {
         check_skip_cutscene_keypress (kgn);
 
         if (play.fast_forward) { }
+        else if ((kgn == 20) && Tracer::IsEnabled()) {
+            // Ctrl+T - save the recent activity trace
+            Tracer::WriteSnapshot();
+        }
         else if (platform->RunPluginHooks(AGSE_KEYPRESS, kgn)) {
             // plugin took the keypress
             DEBUG_CONSOLE("Keypress code %d taken by plugin", kgn);
@@ -719,7 +728,12 @@ void mainloop(bool checkControls, IDriverDependantBitmap *extraBitmap, int extra
     
     int res;
 
-    update_mp3();
+    FrameTimer::StartFrame();
+
+    {
+        FramePhaseScope phase(kFramePhase_Audio);
+        update_mp3();
+    }
 
     numEventsAtStartOfFunction = numevents;
 
@@ -750,23 +764,41 @@ void mainloop(bool checkControls, IDriverDependantBitmap *extraBitmap, int extra
 
     check_debug_keys();
 
-    game_loop_check_controls(checkControls);
+    {
+        FramePhaseScope phase(kFramePhase_Controls);
+        game_loop_check_controls(checkControls);
+    }
 
     our_eip=2;
 
-    game_loop_do_update();
+    {
+        FramePhaseScope phase(kFramePhase_Update);
+        game_loop_do_update();
 
-    game_loop_update_animated_buttons();
+        game_loop_update_animated_buttons();
 
-    game_loop_do_late_update();
+        game_loop_do_late_update();
+    }
 
-    update_polled_audio_and_crossfade();
+    {
+        FramePhaseScope phase(kFramePhase_Audio);
+        update_polled_audio_and_crossfade();
+    }
 
-    game_loop_do_render_and_check_mouse(extraBitmap, extraX, extraY);
+    {
+        FramePhaseScope phase(kFramePhase_Render);
+        game_loop_do_render_and_check_mouse(extraBitmap, extraX, extraY);
+    }
     
     our_eip=6;
 
-    game_loop_update_events();
+    {
+        FramePhaseScope phase(kFramePhase_Events);
+        game_loop_update_events();
+    }
+    update_async_save();
+    update_game_snapshots();
+    update_savegame_index();
 
     our_eip=7;
 
@@ -787,6 +819,7 @@ void mainloop(bool checkControls, IDriverDependantBitmap *extraBitmap, int extra
 
     game_loop_update_fps();
 
+    FramePhaseScope phase(kFramePhase_Wait);
     game_loop_poll_stuff_once_more();
 }
 
@@ -55,6 +55,7 @@ extern int numguiinv;
 extern int scrnwid,scrnhit;
 extern int current_screen_resolution_multiplier;
 extern char force_gfxfilter[50];
+extern char force_gfxdriver[50];
 extern AGSPlatformDriver *platform;
 extern int force_16bit;
 extern IGraphicsDriver *gfxDriver;
@@ -310,27 +311,35 @@ bool initialize_graphics_filter(const char *filterID, int colDepth)
 
 bool pre_create_gfx_driver(const String &gfx_driver_id)
 {
-#ifdef WINDOWS_VERSION
-    if (gfx_driver_id.CompareNoCase("D3D9") == 0 && (game.color_depth != 1))
+    if (gfx_driver_id.CompareNoCase("NULL") == 0)
     {
-        gfxDriver = GetD3DGraphicsDriver(NULL);
-        if (!gfxDriver)
-        {
-            Out::FPrint("Failed to initialize D3D9 driver: %s", get_allegro_error());
-        }
+        gfxDriver = GetNullGraphicsDriver(NULL, usetup.gfx_dump_interval,
+            usetup.gfx_dump_dir, usetup.gfx_timing_file);
     }
     else
+    {
+#ifdef WINDOWS_VERSION
+        if (gfx_driver_id.CompareNoCase("D3D9") == 0 && (game.color_depth != 1))
+        {
+            gfxDriver = GetD3DGraphicsDriver(NULL);
+            if (!gfxDriver)
+            {
+                Out::FPrint("Failed to initialize D3D9 driver: %s", get_allegro_error());
+            }
+        }
+        else
 #endif
 #if defined (IOS_VERSION) || defined(ANDROID_VERSION) || defined(WINDOWS_VERSION)
-    if (gfx_driver_id.CompareNoCase("DX5") != 0 && (psp_gfx_renderer > 0) && (game.color_depth != 1))
-    {
-        gfxDriver = GetOGLGraphicsDriver(NULL);
-        if (!gfxDriver)
+        if (gfx_driver_id.CompareNoCase("DX5") != 0 && (psp_gfx_renderer > 0) && (game.color_depth != 1))
         {
-            Out::FPrint("Failed to initialize OGL driver: %s", get_allegro_error());
+            gfxDriver = GetOGLGraphicsDriver(NULL);
+            if (!gfxDriver)
+            {
+                Out::FPrint("Failed to initialize OGL driver: %s", get_allegro_error());
+            }
         }
-    }
 #endif
+    }
 
     if (!gfxDriver)
     {
@@ -507,6 +516,13 @@ int find_max_supported_uniform_scaling(const Size &base_size, Size &found_size,
 bool try_find_nearest_supported_mode(const Size &base_size, const int scaling_factor, Size &found_size, const int color_depth,
                                      const bool windowed, const bool prefer_sideborders, const bool prefer_letterbox)
 {
+    // Null driver renders into memory, and so supports any size
+    if (stricmp(gfxDriver->GetDriverID(), "NULL") == 0)
+    {
+        found_size = base_size * scaling_factor;
+        return true;
+    }
+
     Size desktop_size;
     if (!get_desktop_size_for_mode(desktop_size, windowed))
     {
@@ -585,6 +601,13 @@ bool try_find_nearest_supported_mode(const Size &base_size, const int scaling_fa
 int try_find_max_supported_uniform_scaling(const Size &base_size, Size &found_size, const int color_depth,
                                            const bool windowed, const bool prefer_sideborders, const bool prefer_letterbox)
 {
+    // Null driver is not limited by display, but there's no use in upscaling
+    if (stricmp(gfxDriver->GetDriverID(), "NULL") == 0)
+    {
+        found_size = base_size;
+        return 1;
+    }
+
     Size desktop_size;
     if (!get_desktop_size_for_mode(desktop_size, windowed))
     {
@@ -1046,6 +1069,9 @@ int graphics_mode_init()
 
     engine_init_screen_settings(game_size, screen_size);
 
+    if (force_gfxdriver[0])
+        usetup.gfxDriverID = force_gfxdriver;
+
     int res = create_gfx_driver_and_init_mode(usetup.gfxDriverID, game_size, screen_size);
     if (res != RETURN_CONTINUE)
     {
@@ -83,6 +83,7 @@ extern char editor_debugger_instance_token[100];
 
 // Startup flags, set from parameters to engine
 char force_gfxfilter[50];
+char force_gfxdriver[50];
 int datafile_argv=0, change_to_game_dir = 0, force_window = 0;
 int override_start_room = 0, force_16bit = 0;
 bool justDisplayHelp = false;
@@ -91,6 +92,7 @@ bool justRunSetup = false;
 bool justRegisterGame = false;
 bool justUnRegisterGame = false;
 const char *loadSaveGameOnStartup = NULL;
+const char *force_trace_file = NULL;
 
 #if !defined(IOS_VERSION) && !defined(PSP_VERSION) && !defined(ANDROID_VERSION)
 int psp_video_framedrop = 1;
@@ -194,6 +196,11 @@ void main_print_help() {
            "  --letterbox                  Enable letterbox mode\n"
            "  --gfxfilter <filter>         Enable graphics filter. Available options:\n"
            "                                 StdScale2, StdScale3, StdScale4, Hq2x or Hq3x\n"
+           "  --gfxdriver <id>             Use specified graphics driver; NULL runs the\n"
+           "                                 engine headless, rendering to memory only\n"
+           "  --frametimes                 Measure and display game loop timings\n"
+           "  --trace <file>               Record engine activity and write it to the file\n"
+           "                                 in Chrome trace format; Ctrl+T saves a snapshot\n"
            "  --log                        Enable program output to the log file\n"
            "  --no-log                     Disable program output to the log file,\n"
            "                                 overriding configuration file setting\n"
@@ -209,6 +216,7 @@ void main_print_help() {
 int main_process_cmdline(int argc,char*argv[])
 {
     force_gfxfilter[0] = '\0';
+    force_gfxdriver[0] = '\0';
 
     for (int ee=1;ee<argc;ee++) {
         if (stricmp(argv[ee],"--help") == 0 || stricmp(argv[ee],"/?") == 0 || stricmp(argv[ee],"-?") == 0)
@@ -239,6 +247,11 @@ int main_process_cmdline(int argc,char*argv[])
             strncpy(force_gfxfilter, argv[ee + 1], 49);
             ee++;
         }
+        else if ((stricmp(argv[ee],"-gfxdriver") == 0 || stricmp(argv[ee],"--gfxdriver") == 0) && (argc > ee + 1))
+        {
+            strncpy(force_gfxdriver, argv[ee + 1], 49);
+            ee++;
+        }
 #ifdef _DEBUG
         else if ((stricmp(argv[ee],"--startr") == 0) && (ee < argc-1)) {
             override_start_room = atoi(argv[ee+1]);
@@ -253,6 +266,12 @@ int main_process_cmdline(int argc,char*argv[])
         else if (stricmp(argv[ee],"--15bit")==0) debug_15bit_mode = 1;
         else if (stricmp(argv[ee],"--24bit")==0) debug_24bit_mode = 1;
         else if (stricmp(argv[ee],"--fps")==0) display_fps = 2;
+        else if (stricmp(argv[ee],"--frametimes")==0) usetup.frame_timing = true;
+        else if ((stricmp(argv[ee],"--trace")==0) && (argc > ee + 1))
+        {
+            force_trace_file = argv[ee + 1];
+            ee++;
+        }
         else if (stricmp(argv[ee],"--test")==0) debug_flags|=DBG_DEBUGMODE;
         else if (stricmp(argv[ee],"-noiface")==0) debug_flags|=DBG_NOIFACE;
         else if (stricmp(argv[ee],"-nosprdisp")==0) debug_flags|=DBG_NODRAWSPRITES;
@@ -47,6 +47,7 @@ extern int override_start_room, force_16bit;
 extern bool justRegisterGame;
 extern bool justUnRegisterGame;
 extern const char *loadSaveGameOnStartup;
+extern const char *force_trace_file;
 
 extern int psp_video_framedrop;
 extern int psp_audio_enabled;
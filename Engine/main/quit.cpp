@@ -17,15 +17,20 @@
 //
 
 #include "gfx/ali3d.h"
+#include "ac/asyncsave.h"
 #include "ac/cdaudio.h"
 #include "ac/gamesetup.h"
 #include "ac/gamesetupstruct.h"
+#include "ac/gamesnapshot.h"
 #include "ac/record.h"
 #include "ac/roomstatus.h"
+#include "ac/savegameindex.h"
 #include "ac/translation.h"
 #include "debug/agseditordebugger.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
+#include "debug/frametimer.h"
+#include "debug/tracer.h"
 #include "debug/out.h"
 #include "font/fonts.h"
 #include "main/config.h"
@@ -35,6 +40,7 @@
 #include "main/quit.h"
 #include "ac/spritecache.h"
 #include "gfx/graphicsdriver.h"
+#include "gfx/rowworkers.h"
 #include "gfx/bitmap.h"
 #include "core/assetmanager.h"
 
@@ -130,7 +136,7 @@ void quit_shutdown_audio()
 #endif
 
     // Quit the sound thread.
-    audioThread.Stop();
+    stop_audio_thread();
 
     remove_sound();
 }
@@ -284,6 +290,10 @@ void quit(const char *quitmsg)
 
     stop_recording();
 
+    shutdown_async_save();
+    free_game_snapshots();
+    update_savegame_index();
+
     quit_stop_cd();
 
     our_eip = 9020;
@@ -310,6 +320,7 @@ void quit(const char *quitmsg)
     our_eip = 9908;
 
     graphics_mode_shutdown();
+    shutdown_row_workers();
 
     quit_message_on_exit(qmsg, alertis, qreason);
 
@@ -330,6 +341,8 @@ void quit(const char *quitmsg)
 
     Out::FPrint("***** ENGINE HAS SHUTDOWN");
 
+    FrameTimer::Shutdown();
+    Tracer::Shutdown();
     shutdown_debug_system();
     free_globals();
 
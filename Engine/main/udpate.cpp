@@ -50,6 +50,7 @@ extern RoomObject*objs;
 extern ViewStruct*views;
 extern int spritewidth[MAX_SPRITES],spriteheight[MAX_SPRITES];
 extern int our_eip;
+extern int displayed_room;
 extern CharacterInfo*playerchar;
 extern CharacterExtras *charextra;
 extern CharacterInfo *facetalkchar;
@@ -213,6 +214,19 @@ void update_shadow_areas()
   }
 }
 
+// Tells whether updating the character could change anything. Characters
+// outside of the current room are only updated when they follow someone,
+// turn round, or have their loop or idle state to be reset; for all the
+// others UpdateMoveAndAnim does nothing.
+inline bool is_character_update_needed(const CharacterInfo *chi, const CharacterExtras *chex)
+{
+  return (chi->room == displayed_room) ||
+    (chi->following >= 0) ||
+    (chi->walking >= TURNING_AROUND) ||
+    ((chi->view >= 0) && (chi->loop >= views[chi->view].numLoops)) ||
+    (chex->process_idle_this_time != 0);
+}
+
 void update_character_move_and_anim(int &numSheep, int *followingAsSheep)
 {
 	// move & animate characters
@@ -221,6 +235,7 @@ void update_character_move_and_anim(int &numSheep, int *followingAsSheep)
 
     CharacterInfo*chi    = &game.chars[aa];
 	CharacterExtras*chex = &charextra[aa];
+    if (!is_character_update_needed(chi, chex)) continue;
 
 	chi->UpdateMoveAndAnim(aa, chex, numSheep, followingAsSheep);
   }
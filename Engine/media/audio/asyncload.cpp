@@ -0,0 +1,416 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "media/audio/asyncload.h"
+
+#if defined(WINDOWS_VERSION) || defined(LINUX_VERSION) || defined(MAC_VERSION) || \
+    defined(IOS_VERSION) || defined(ANDROID_VERSION)
+#define AGS_HAS_ASYNC_CLIP_LOADER
+#endif
+
+#if defined(AGS_HAS_ASYNC_CLIP_LOADER)
+
+#include <stdlib.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include "util/wgt2allg.h"
+#include "ac/gamesetup.h"
+#include "ac/dynobj/scriptaudioclip.h"
+#include "debug/debug_log.h"
+#include "debug/out.h"
+#include "debug/tracer.h"
+#include "media/audio/audio.h"
+#include "media/audio/audiocommands.h"
+#include "media/audio/audiodefines.h"
+#include "media/audio/audiointernaldefs.h"
+#include "media/audio/soundclip.h"
+#include "media/audio/sound.h"
+#include "media/audio/soundcache.h"
+#include "util/mutex_lock.h"
+#include "util/semaphore.h"
+#include "util/string.h"
+#include "util/thread.h"
+
+using AGS::Common::String;
+using AGS::Engine::Mutex;
+using AGS::Engine::MutexLock;
+using AGS::Engine::Semaphore;
+using AGS::Engine::Thread;
+namespace Out = AGS::Common::Out;
+
+extern GameSetup usetup;
+
+struct AsyncClipJob
+{
+    PACKFILE  *In;          // opened on the main thread, closed by the loader
+    String     FileName;
+    int        FileType;
+    long       Size;
+    int        Volume;
+    bool       Repeat;
+    SOUNDCLIP *Result;      // loaded clip, or NULL if loading failed
+    bool       Done;        // loader has finished with the job
+    bool       Cancelled;   // placeholder was destroyed before the job was done
+    Semaphore  Finished;
+};
+
+// Placeholder for the clip being loaded
+struct MYLOADINGCLIP : public SOUNDCLIP
+{
+    AsyncClipJob *job;
+    int fileType;
+    int startPosition;
+
+    int poll() { return done; }
+    void destroy();
+    void set_volume(int newvol) { vol = newvol; }
+    void restart() { startPosition = 0; }
+    void seek(int pos) { startPosition = pos; }
+    int get_pos() { return startPosition; }
+    int get_pos_ms() { return startPosition; }
+    int get_length_ms();
+    int get_voice() { return -1; }
+    int get_sound_type() { return fileType == eAudioFileMP3 ? MUS_MP3 : MUS_OGG; }
+    int play() { _playing = true; return play_from(0); }
+    int play_from(int position) { startPosition = position; return 1; }
+    void set_panning(int newPanning) { panning = newPanning; }
+    void pause() { paused = 1; }
+    void resume() { paused = 0; }
+
+    // Tells whether the loader has finished with the clip
+    bool is_loaded();
+    // Waits until the loader finishes and returns the loaded clip, which is
+    // still owned by the placeholder
+    SOUNDCLIP *wait_for_load();
+    // Takes the loaded clip from the placeholder and makes it match the
+    // placeholder's settings
+    SOUNDCLIP *take_loaded_clip();
+
+    MYLOADINGCLIP(AsyncClipJob *loadJob, int type);
+    ~MYLOADINGCLIP();
+};
+
+Thread                      loader_thread;
+int                         loader_state = -1; // -1 not started, 0 not available, 1 running
+volatile bool               loader_quit = false;
+Mutex                       loader_mutex;
+Semaphore                   loader_wake;
+std::deque<AsyncClipJob*>   loader_queue;
+// Placeholders which exist at the moment; used only on the main thread
+std::vector<MYLOADINGCLIP*> loading_clips;
+
+SOUNDCLIP *load_job_clip(AsyncClipJob *job)
+{
+    char *data = (char*)malloc(job->Size);
+    if (data == NULL)
+        return NULL;
+    if (pack_fread(data, job->Size, job->In) != job->Size)
+    {
+        free(data);
+        return NULL;
+    }
+    data = put_sound_to_cache(job->FileName, data, job->Size);
+    if (job->FileType == eAudioFileMP3)
+        return my_load_static_mp3_from_buffer(job->FileName, data, job->Size, job->Volume, job->Repeat);
+    return my_load_static_ogg_from_buffer(job->FileName, data, job->Size, job->Volume, job->Repeat);
+}
+
+void delete_job_clip(AsyncClipJob *job)
+{
+    if (job->Result)
+    {
+        job->Result->destroy();
+        delete job->Result;
+        job->Result = NULL;
+    }
+}
+
+void async_loader_entry()
+{
+    // The thread entry is called repeatedly until the thread is stopped
+    if (loader_quit)
+        return;
+    loader_wake.Wait();
+    if (loader_quit)
+        return;
+
+    MutexLock lock(loader_mutex);
+    if (loader_queue.empty())
+        return;
+    AsyncClipJob *job = loader_queue.front();
+    loader_queue.pop_front();
+    const bool cancelled = job->Cancelled;
+    lock.Release();
+
+    SOUNDCLIP *clip = NULL;
+    if (!cancelled)
+    {
+        TraceScope trace("audio", "load_clip", "size", job->Size);
+        clip = load_job_clip(job);
+    }
+    pack_fclose(job->In);
+    job->In = NULL;
+
+    lock.Acquire(loader_mutex);
+    job->Result = clip;
+    job->Done = true;
+    if (job->Cancelled)
+    {
+        delete_job_clip(job);
+        delete job;
+        return;
+    }
+    job->Finished.Post();
+}
+
+void async_loader_thread_entry()
+{
+    static bool thread_named = false;
+    if (!thread_named)
+    {
+        Tracer::SetThreadName("audio loader");
+        thread_named = true;
+    }
+    async_loader_entry();
+}
+
+bool start_async_clip_loader()
+{
+    if (loader_state < 0)
+    {
+        loader_quit = false;
+        loader_state = loader_thread.CreateAndStart(async_loader_thread_entry, true) ? 1 : 0;
+        Out::FPrint(loader_state > 0 ? "Started audio clip loader thread" :
+            "Failed to start audio clip loader thread, clips will be loaded synchronously");
+    }
+    return loader_state > 0;
+}
+
+MYLOADINGCLIP::MYLOADINGCLIP(AsyncClipJob *loadJob, int type) : SOUNDCLIP()
+{
+    job = loadJob;
+    fileType = type;
+    startPosition = 0;
+    loading_clips.push_back(this);
+}
+
+MYLOADINGCLIP::~MYLOADINGCLIP()
+{
+    destroy();
+    loading_clips.erase(std::remove(loading_clips.begin(), loading_clips.end(), this), loading_clips.end());
+}
+
+void MYLOADINGCLIP::destroy()
+{
+    if (job == NULL)
+        return;
+    MutexLock lock(loader_mutex);
+    if (job->Done)
+    {
+        delete_job_clip(job);
+        delete job;
+    }
+    else
+    {
+        // The loader deletes the job when it gets to it
+        job->Cancelled = true;
+    }
+    job = NULL;
+}
+
+int MYLOADINGCLIP::get_length_ms()
+{
+    // Scripts expect to know the length right after starting the clip
+    SOUNDCLIP *clip = wait_for_load();
+    return clip ? clip->get_length_ms() : 0;
+}
+
+bool MYLOADINGCLIP::is_loaded()
+{
+    if (job == NULL)
+        return true;
+    MutexLock lock(loader_mutex);
+    return job->Done;
+}
+
+SOUNDCLIP *MYLOADINGCLIP::wait_for_load()
+{
+    if (job == NULL)
+        return NULL;
+    MutexLock lock(loader_mutex);
+    if (!job->Done)
+    {
+        lock.Release();
+        job->Finished.Wait();
+        lock.Acquire(loader_mutex);
+    }
+    return job->Result;
+}
+
+SOUNDCLIP *MYLOADINGCLIP::take_loaded_clip()
+{
+    SOUNDCLIP *clip = wait_for_load();
+    if (clip == NULL)
+        return NULL;
+    job->Result = NULL;
+
+    clip->priority = priority;
+    clip->soundType = soundType;
+    clip->sourceClip = sourceClip;
+    clip->volAsPercentage = volAsPercentage;
+    clip->originalVolAsPercentage = originalVolAsPercentage;
+    clip->volModifier = volModifier;
+    clip->directionalVolModifier = directionalVolModifier;
+    clip->panning = panning;
+    clip->panningAsPercentage = panningAsPercentage;
+    clip->xSource = xSource;
+    clip->ySource = ySource;
+    clip->maximumPossibleDistanceAway = maximumPossibleDistanceAway;
+    clip->_playing = _playing;
+    clip->set_volume(vol);
+    return clip;
+}
+
+MYLOADINGCLIP *find_loading_clip(SOUNDCLIP *clip)
+{
+    for (size_t i = 0; i < loading_clips.size(); ++i)
+    {
+        if (loading_clips[i] == clip)
+            return loading_clips[i];
+    }
+    return NULL;
+}
+
+SOUNDCLIP *load_sound_clip_async(ScriptAudioClip *audioClip, const char *filename, bool repeat)
+{
+    if ((usetup.async_audio_types & (1 << audioClip->type)) == 0)
+        return NULL;
+    // Only the clips which are decoded from memory take long to load
+    if ((audioClip->fileType != eAudioFileOGG) && (audioClip->fileType != eAudioFileMP3))
+        return NULL;
+    // Cached clips are quick to load anyway
+    if (is_sound_cached(filename))
+        return NULL;
+    if (!start_async_clip_loader())
+        return NULL;
+
+    PACKFILE *in = pack_fopen(filename, "rb");
+    if (in == NULL)
+        return NULL;
+
+    AsyncClipJob *job = new AsyncClipJob();
+    job->In = in;
+    job->FileName = filename;
+    job->FileType = audioClip->fileType;
+    job->Size = in->todo;
+    job->Volume = audioClip->defaultVolume;
+    job->Repeat = repeat;
+    job->Result = NULL;
+    job->Done = false;
+    job->Cancelled = false;
+
+    MutexLock lock(loader_mutex);
+    loader_queue.push_back(job);
+    lock.Release();
+    loader_wake.Post();
+
+    MYLOADINGCLIP *loading = new MYLOADINGCLIP(job, audioClip->fileType);
+    loading->repeat = repeat;
+    return loading;
+}
+
+void update_async_clip_loads()
+{
+    if (loading_clips.empty())
+        return;
+
+    // Only the placeholders which are in the channels have been told to play;
+    // those waiting in the music queue are swapped when they get a channel
+    for (int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+    {
+        MYLOADINGCLIP *loading = find_loading_clip(channels[i]);
+        if ((loading == NULL) || loading->done || !loading->is_loaded())
+            continue;
+
+        // Apply the commands posted for the placeholder before the audio
+        // thread may poll the real clip
+        MutexLock lock(_audio_poll_mutex);
+        apply_audio_commands();
+        SOUNDCLIP *clip = loading->take_loaded_clip();
+        if (clip == NULL)
+        {
+            // Leave the finished placeholder in the channel, same as a clip
+            // which has stopped playing
+            DEBUG_CONSOLE("AudioClip.Play: unable to load sound file");
+            loading->done = 1;
+            continue;
+        }
+        if (clip->play_from(loading->startPosition) == 0)
+        {
+            DEBUG_CONSOLE("AudioClip.Play: failed to play sound file");
+            loading->done = 1;
+            continue;
+        }
+        if (loading->paused)
+            clip->pause();
+        audio_channel_clip_removed(i);
+        channels[i] = clip;
+        lock.Release();
+        delete loading;
+    }
+}
+
+void shutdown_async_clip_loader()
+{
+    if (loader_state > 0)
+    {
+        loader_quit = true;
+        loader_wake.Post();
+        loader_thread.Stop();
+    }
+    loader_state = 0;
+
+    // Fail the jobs which the loader did not get to
+    MutexLock lock(loader_mutex);
+    for (size_t i = 0; i < loader_queue.size(); ++i)
+    {
+        AsyncClipJob *job = loader_queue[i];
+        pack_fclose(job->In);
+        job->In = NULL;
+        job->Done = true;
+        if (job->Cancelled)
+            delete job;
+        else
+            job->Finished.Post();
+    }
+    loader_queue.clear();
+}
+
+#else // !AGS_HAS_ASYNC_CLIP_LOADER
+
+SOUNDCLIP *load_sound_clip_async(ScriptAudioClip *audioClip, const char *filename, bool repeat)
+{
+    return NULL;
+}
+
+void update_async_clip_loads()
+{
+}
+
+void shutdown_async_clip_loader()
+{
+}
+
+#endif // AGS_HAS_ASYNC_CLIP_LOADER
@@ -0,0 +1,39 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Loading audio clips in background.
+//
+// The clip file is opened on the main thread, because the asset manager is
+// not thread-safe, but the file is read and the decoder created on a worker
+// thread. Until then the clip is represented by a placeholder, which takes
+// the channel and remembers volume, panning, position and pause changes, and
+// is replaced by the real clip once that is loaded.
+//
+//=============================================================================
+#ifndef __AC_ASYNCLOAD_H
+#define __AC_ASYNCLOAD_H
+
+struct SOUNDCLIP;
+struct ScriptAudioClip;
+
+// Starts loading the clip in background and returns its placeholder;
+// returns NULL if the clip should be loaded the usual way instead
+SOUNDCLIP *load_sound_clip_async(ScriptAudioClip *audioClip, const char *filename, bool repeat);
+// Puts the loaded clips in place of their placeholders in the channels
+// and starts playing them; must be called with the audio mutex locked
+void update_async_clip_loads();
+// Stops the loader thread; clips are loaded the usual way after this
+void shutdown_async_clip_loader();
+
+#endif // __AC_ASYNCLOAD_H
@@ -23,19 +23,25 @@
 #include "ac/audiochannel.h"
 #include "ac/audioclip.h"
 #include "ac/gamesetup.h"
+#include "media/audio/asyncload.h"
+#include "media/audio/audiocommands.h"
 #include "media/audio/sound.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
+#include "debug/tracer.h"
 #include "ac/common.h"
 #include "ac/global_audio.h"
 #include "ac/roomstruct.h"
 #include <math.h>
 #include "util/stream.h"
+#include "util/math.h"
+#include "util/semaphore.h"
 #include "core/assetmanager.h"
 
 using AGS::Common::Stream;
 
 AGS::Engine::Mutex _audio_mutex;
+AGS::Engine::Mutex _audio_poll_mutex;
 volatile bool _audio_doing_crossfade;
 
 extern GameSetupStruct game;
@@ -229,7 +235,7 @@ bool is_audiotype_allowed_to_play(AudioFileType type)
            type != eAudioFileMIDI && usetup.digicard != DIGI_NONE;
 }
 
-SOUNDCLIP *load_sound_clip(ScriptAudioClip *audioClip, bool repeat)
+SOUNDCLIP *load_sound_clip(ScriptAudioClip *audioClip, bool repeat, bool allowAsync)
 {
     const char *clipFileName = get_audio_clip_file_name(audioClip);
     if ((clipFileName == NULL) || !is_audiotype_allowed_to_play((AudioFileType)audioClip->fileType))
@@ -240,30 +246,35 @@ SOUNDCLIP *load_sound_clip(ScriptAudioClip *audioClip, bool repeat)
     update_clip_default_volume(audioClip);
 
     SOUNDCLIP *soundClip = NULL;
-    switch (audioClip->fileType)
+    if (allowAsync)
+        soundClip = load_sound_clip_async(audioClip, clipFileName, repeat);
+    if (soundClip == NULL)
     {
-    case eAudioFileOGG:
-        soundClip = my_load_static_ogg(clipFileName, audioClip->defaultVolume, repeat);
-        break;
-    case eAudioFileMP3:
-        soundClip = my_load_static_mp3(clipFileName, audioClip->defaultVolume, repeat);
-        break;
-    case eAudioFileWAV:
-    case eAudioFileVOC:
-        soundClip = my_load_wave(clipFileName, audioClip->defaultVolume, repeat);
-        break;
-    case eAudioFileMIDI:
-        soundClip = my_load_midi(clipFileName, repeat);
-        break;
-    case eAudioFileMOD:
+        switch (audioClip->fileType)
+        {
+        case eAudioFileOGG:
+            soundClip = my_load_static_ogg(clipFileName, audioClip->defaultVolume, repeat);
+            break;
+        case eAudioFileMP3:
+            soundClip = my_load_static_mp3(clipFileName, audioClip->defaultVolume, repeat);
+            break;
+        case eAudioFileWAV:
+        case eAudioFileVOC:
+            soundClip = my_load_wave(clipFileName, audioClip->defaultVolume, repeat);
+            break;
+        case eAudioFileMIDI:
+            soundClip = my_load_midi(clipFileName, repeat);
+            break;
+        case eAudioFileMOD:
 #ifndef PSP_NO_MOD_PLAYBACK
-        soundClip = my_load_mod(clipFileName, repeat);
+            soundClip = my_load_mod(clipFileName, repeat);
 #else
-        soundClip = NULL;
+            soundClip = NULL;
 #endif
-        break;
-    default:
-        quitprintf("AudioClip.Play: invalid audio file type encountered: %d", audioClip->fileType);
+            break;
+        default:
+            quitprintf("AudioClip.Play: invalid audio file type encountered: %d", audioClip->fileType);
+        }
     }
     if (soundClip != NULL)
     {
@@ -284,6 +295,8 @@ void recache_queued_clips_after_loading_save_game()
 
 void audio_update_polled_stuff()
 {
+    update_async_clip_loads();
+
     play.crossfade_step++;
 
     if (play.crossfading_out_channel > 0)
@@ -349,7 +362,7 @@ void queue_audio_clip_to_play(ScriptAudioClip *clip, int priority, int repeat)
         return;
     }
 
-    SOUNDCLIP *cachedClip = load_sound_clip(clip, (repeat != 0));
+    SOUNDCLIP *cachedClip = load_sound_clip(clip, (repeat != 0), true);
     if (cachedClip != NULL) 
     {
         play.new_music_queue[play.new_music_queue_size].audioClipIndex = clip->id;
@@ -367,7 +380,7 @@ ScriptAudioChannel* play_audio_clip_on_channel(int channel, ScriptAudioClip *cli
 {
     if (soundfx == NULL)
     {
-        soundfx = load_sound_clip(clip, (repeat) ? true : false);
+        soundfx = load_sound_clip(clip, (repeat) ? true : false, true);
     }
     if (soundfx == NULL)
     {
@@ -409,6 +422,7 @@ ScriptAudioChannel* play_audio_clip_on_channel(int channel, ScriptAudioClip *cli
 
     last_sound_played[channel] = -1;
     channels[channel] = soundfx;
+    audio_thread_notify();
     return &scrAudioChannel[channel];
 }
 
@@ -501,9 +515,14 @@ void stop_and_destroy_channel_ex(int chid, bool resetLegacyMusicSettings) {
         quit("!StopChannel: invalid channel ID");
 
     if (channels[chid] != NULL) {
-        channels[chid]->destroy();
-        delete channels[chid];
+        SOUNDCLIP *clip = channels[chid];
+        clip->destroy();
+        // The audio thread may be polling the clip right now
+        AGS::Engine::MutexLock _lock(_audio_poll_mutex);
+        audio_channel_clip_removed(chid);
         channels[chid] = NULL;
+        _lock.Release();
+        delete clip;
     }
 
     if (play.crossfading_in_channel == chid)
@@ -612,6 +631,7 @@ void update_directional_sound_vol()
         if ((channels[chan] != NULL) && (channels[chan]->done == 0) &&
             (channels[chan]->xSource >= 0)) 
         {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             channels[chan]->directionalVolModifier = 
                 get_volume_adjusted_for_distance(channels[chan]->vol, 
                 channels[chan]->xSource,
@@ -663,6 +683,7 @@ void update_ambient_sound_vol () {
         if (channels[thisSound->channel] == NULL)
             quit("Internal error: the ambient sound channel is enabled, but it has been destroyed");
 
+        AGS::Engine::MutexLock _lock(_audio_poll_mutex);
         channels[thisSound->channel]->set_volume(wantvol);
     }
 }
@@ -693,6 +714,7 @@ void stop_all_sound_and_music()
 void shutdown_sound() 
 {
     stop_all_sound_and_music();
+    shutdown_async_clip_loader();
 
 #ifndef PSP_NO_MOD_PLAYBACK
     if (opts.mod_player)
@@ -857,6 +879,7 @@ void apply_volume_drop_modifier(bool applyModifier)
     {
         if ((channels[i] != NULL) && (channels[i]->done == 0) && (channels[i]->sourceClip != NULL))
         {
+            AGS::Engine::MutexLock _lock(_audio_poll_mutex);
             if (applyModifier)
             {
                 int audioType = ((ScriptAudioClip*)channels[i]->sourceClip)->type;
@@ -871,15 +894,86 @@ void apply_volume_drop_modifier(bool applyModifier)
 extern volatile char want_exit;
 extern int frames_per_second;
 
-void update_mp3_thread()
+bool update_mp3_thread()
 {
-	while (switching_away_from_game) { }
-	AGS::Engine::MutexLock _lock(_audio_mutex);
+	// The game thread pauses all the channels when switching away
+	if (switching_away_from_game)
+		return true;
+	TraceScope trace("audio", "audio_poll");
+	if (psp_audio_multithreaded)
+	{
+		AGS::Engine::MutexLock _lock(_audio_poll_mutex);
+		apply_audio_commands();
+	}
+	bool playing = false;
 	for (musicPollIterator = 0; musicPollIterator <= MAX_SOUND_CHANNELS; ++musicPollIterator)
 	{
-		if ((channels[musicPollIterator] != NULL) && (channels[musicPollIterator]->done == 0))
-			channels[musicPollIterator]->poll();
+		// Lock only while polling a single channel, so that the game thread
+		// does not wait for decoding unless it deletes that very clip
+		AGS::Engine::MutexLock _lock(_audio_poll_mutex);
+		SOUNDCLIP *clip = channels[musicPollIterator];
+		if ((clip != NULL) && (clip->done == 0))
+		{
+			clip->poll();
+			playing = true;
+			if (psp_audio_multithreaded && (clip->done == 0))
+				publish_audio_channel_state(musicPollIterator);
+		}
 	}
+	return playing;
+}
+
+#if defined(WINDOWS_VERSION) || defined(LINUX_VERSION) || defined(MAC_VERSION) || \
+    defined(IOS_VERSION) || defined(ANDROID_VERSION)
+#define AGS_HAS_AUDIO_THREAD_WAKEUP
+AGS::Engine::Semaphore audio_thread_wakeup;
+#endif
+volatile bool audio_thread_notified = false;
+volatile bool audio_thread_idle = false;
+volatile bool audio_thread_quit = false;
+// How long the audio thread sleeps while nothing is playing; the game thread
+// wakes it up when clips start, so this is only a precaution
+const int AUDIO_THREAD_IDLE_WAIT = 1000;
+
+void audio_thread_notify()
+{
+    if (audio_thread_notified)
+        return;
+    audio_thread_notified = true;
+#if defined(AGS_HAS_AUDIO_THREAD_WAKEUP)
+    audio_thread_wakeup.Post();
+#endif
+}
+
+int get_audio_poll_interval()
+{
+    // Streams play one half of their buffer while the other half is refilled.
+    // The buffer size is given in bytes of 16-bit samples, so the shortest
+    // half is the one of a 44.1 kHz stereo clip; poll four times during it,
+    // which leaves room for late wakeups when the system is under load.
+    const int half_buffer_ms = audio_stream_buffer_size * 1000 / (2 * 44100 * 2 * 2);
+    return AGS::Common::Math::Max(half_buffer_ms / 4, 5);
+}
+
+void wait_for_audio_thread_wakeup(bool playing)
+{
+    if (audio_thread_quit)
+        return;
+#if defined(AGS_HAS_AUDIO_THREAD_WAKEUP)
+    audio_thread_idle = !playing;
+    audio_thread_wakeup.WaitTimeout(playing ? get_audio_poll_interval() : AUDIO_THREAD_IDLE_WAIT);
+    audio_thread_idle = false;
+#else
+    platform->Delay(get_audio_poll_interval());
+#endif
+    audio_thread_notified = false;
+}
+
+void stop_audio_thread()
+{
+    audio_thread_quit = true;
+    audio_thread_notify();
+    audioThread.Stop();
 }
 
 void update_mp3()
@@ -911,6 +1005,19 @@ void update_polled_audio_and_crossfade ()
 
     audio_update_polled_stuff();
 
+    // Wake the idle audio thread up if anything has started playing
+    if (audio_thread_idle)
+    {
+        for (int i = 0; i <= MAX_SOUND_CHANNELS; ++i)
+        {
+            if ((channels[i] != NULL) && (channels[i]->done == 0))
+            {
+                audio_thread_notify();
+                break;
+            }
+        }
+    }
+
     if (crossFading) {
         crossFadeStep++;
         update_music_volume();
@@ -1006,20 +1113,24 @@ void update_music_volume() {
                 newvol = targetVol;
                 stop_and_destroy_channel_ex(SCHAN_MUSIC, false);
                 if (crossFading > 0) {
+                    AGS::Engine::MutexLock _lock(_audio_poll_mutex);
                     channels[SCHAN_MUSIC] = channels[crossFading];
                     channels[crossFading] = NULL;
                 }
                 crossFading = 0;
             }
             else {
-                if (crossFading > 0)
+                if (crossFading > 0) {
+                    AGS::Engine::MutexLock _lock(_audio_poll_mutex);
                     channels[crossFading]->set_volume((curvol > targetVol) ? targetVol : curvol);
+                }
 
                 newvol -= curvol;
                 if (newvol < 0)
                     newvol = 0;
             }
         }
+        AGS::Engine::MutexLock _lock(_audio_poll_mutex);
         if (channels[SCHAN_MUSIC])
             channels[SCHAN_MUSIC]->set_volume (newvol);
     }
@@ -33,7 +33,9 @@ void        move_track_to_crossfade_channel(int currentChannel, int crossfadeSpe
 void        stop_or_fade_out_channel(int fadeOutChannel, int fadeInChannel = -1, ScriptAudioClip *newSound = NULL);
 const char *get_audio_clip_file_name(ScriptAudioClip *clip);
 int         find_free_audio_channel(ScriptAudioClip *clip, int priority, bool interruptEqualPriority);
-SOUNDCLIP*  load_sound_clip(ScriptAudioClip *audioClip, bool repeat);
+// allowAsync lets the clip be loaded in background, if configured so; the
+// returned clip may then be a placeholder until update_async_clip_loads()
+SOUNDCLIP*  load_sound_clip(ScriptAudioClip *audioClip, bool repeat, bool allowAsync = false);
 void        recache_queued_clips_after_loading_save_game();
 void        audio_update_polled_stuff();
 void        queue_audio_clip_to_play(ScriptAudioClip *clip, int priority, int repeat);
@@ -94,12 +96,18 @@ void        newmusic(int mnum);
 
 extern AGS::Engine::Thread audioThread;
 extern AGS::Engine::Mutex _audio_mutex;
+// Locked by the audio thread while it polls a channel
+extern AGS::Engine::Mutex _audio_poll_mutex;
 extern volatile bool _audio_doing_crossfade;
 extern SOUNDCLIP *channels[MAX_SOUND_CHANNELS+1]; // needed for update_mp3_thread
 extern volatile int psp_audio_multithreaded;
 
 void update_mp3();
-void update_mp3_thread();
+// Polls the playing clips; returns whether any of them are playing
+bool update_mp3_thread();
+// Sleeps until the clips need polling again, or the thread is woken up
+void wait_for_audio_thread_wakeup(bool playing);
+void stop_audio_thread();
 
 extern volatile int mvolcounter;
 extern int update_music_at;
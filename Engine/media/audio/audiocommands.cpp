@@ -0,0 +1,244 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "media/audio/audiocommands.h"
+#include "media/audio/audio.h"
+#include "media/audio/soundclip.h"
+#include "util/mutex_lock.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+// Stores are not reordered with other stores on x86, so it is enough to
+// stop the compiler from doing so
+#define AGS_MEMORY_BARRIER() _ReadWriteBarrier()
+#else
+#define AGS_MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+enum AudioCommandType
+{
+    kAudioCmd_SetVolume,
+    kAudioCmd_SetPanning,
+    kAudioCmd_Seek
+};
+
+struct AudioCommand
+{
+    AudioCommandType Type;
+    int         Channel;
+    SOUNDCLIP  *Clip;       // the clip which was in the channel when posting
+    int         Generation; // channel generation when posting
+    int         Value;
+    unsigned    Seq;
+};
+
+// Channel state published by the audio thread; Version is odd while
+// the state is being written
+struct ChannelSnapshot
+{
+    volatile unsigned Version;
+    SOUNDCLIP  *Clip;
+    int         Generation;
+    int         Pos;
+    int         PosMs;
+};
+
+// Requested seek which the audio thread has not done yet
+struct PendingSeek
+{
+    unsigned    Seq;
+    int         Position;
+};
+
+const int AudioCommandQueueSize = 256;
+
+// Single producer (game thread), single consumer (audio thread) ring buffer
+AudioCommand      audio_commands[AudioCommandQueueSize];
+volatile int      audio_command_head = 0; // where the next command is written
+volatile int      audio_command_tail = 0; // where the next command is read
+volatile unsigned audio_command_applied = 0; // Seq of the last applied command
+unsigned          audio_command_seq = 0;
+// Increased when a channel's clip is removed, written under the poll lock
+int               channel_generation[MAX_SOUND_CHANNELS + 1];
+ChannelSnapshot   channel_snapshots[MAX_SOUND_CHANNELS + 1];
+PendingSeek       pending_seeks[MAX_SOUND_CHANNELS + 1];
+
+void apply_audio_command(SOUNDCLIP *clip, AudioCommandType type, int value)
+{
+    switch (type)
+    {
+    case kAudioCmd_SetVolume:
+        clip->set_volume(value);
+        break;
+    case kAudioCmd_SetPanning:
+        clip->set_panning(value);
+        break;
+    case kAudioCmd_Seek:
+        clip->seek(value);
+        break;
+    }
+}
+
+void post_audio_command(AudioCommandType type, int channel, int value)
+{
+    SOUNDCLIP *clip = channels[channel];
+    AudioCommand &cmd = audio_commands[audio_command_head];
+    const int next = (audio_command_head + 1) % AudioCommandQueueSize;
+    if (next == audio_command_tail)
+    {
+        // The queue is full; wait for the audio thread to finish its poll,
+        // and apply the queued commands first to keep them in order
+        AGS::Engine::MutexLock _lock(_audio_poll_mutex);
+        apply_audio_commands();
+        apply_audio_command(clip, type, value);
+        return;
+    }
+
+    cmd.Type = type;
+    cmd.Channel = channel;
+    cmd.Clip = clip;
+    cmd.Generation = channel_generation[channel];
+    cmd.Value = value;
+    cmd.Seq = ++audio_command_seq;
+    // The command must be complete before the audio thread may see it
+    AGS_MEMORY_BARRIER();
+    audio_command_head = next;
+    if (type == kAudioCmd_Seek)
+    {
+        pending_seeks[channel].Seq = cmd.Seq;
+        pending_seeks[channel].Position = value;
+    }
+    audio_thread_notify();
+}
+
+void audio_channel_set_volume(int channel, int volume)
+{
+    if (!psp_audio_multithreaded)
+    {
+        channels[channel]->set_volume(volume);
+        return;
+    }
+    // The game logic reads the absolute volume back when applying modifiers
+    channels[channel]->vol = volume;
+    post_audio_command(kAudioCmd_SetVolume, channel, volume);
+}
+
+void audio_channel_set_panning(int channel, int panning)
+{
+    if (!psp_audio_multithreaded)
+        channels[channel]->set_panning(panning);
+    else
+        post_audio_command(kAudioCmd_SetPanning, channel, panning);
+}
+
+void audio_channel_seek(int channel, int position)
+{
+    if (!psp_audio_multithreaded)
+        channels[channel]->seek(position);
+    else
+        post_audio_command(kAudioCmd_Seek, channel, position);
+}
+
+// Reads the published state of the channel's current clip; returns false if
+// the clip has not been polled yet
+bool read_channel_snapshot(int channel, int &pos, int &pos_ms)
+{
+    const ChannelSnapshot &snap = channel_snapshots[channel];
+    unsigned version;
+    SOUNDCLIP *clip;
+    int generation;
+    do
+    {
+        version = snap.Version;
+        AGS_MEMORY_BARRIER();
+        clip = snap.Clip;
+        generation = snap.Generation;
+        pos = snap.Pos;
+        pos_ms = snap.PosMs;
+        AGS_MEMORY_BARRIER();
+    }
+    while ((version & 1) || (version != snap.Version));
+    return (clip == channels[channel]) && (generation == channel_generation[channel]);
+}
+
+int get_channel_position(int channel, bool in_ms)
+{
+    if (!psp_audio_multithreaded)
+        return in_ms ? channels[channel]->get_pos_ms() : channels[channel]->get_pos();
+
+    // Report the requested position until the seek is done; sequence numbers
+    // are compared by difference to survive the wrap-around
+    const PendingSeek &seek = pending_seeks[channel];
+    if ((seek.Seq != 0) && ((int)(audio_command_applied - seek.Seq) < 0))
+        return seek.Position;
+
+    int pos, pos_ms;
+    if (read_channel_snapshot(channel, pos, pos_ms))
+        return in_ms ? pos_ms : pos;
+    // The clip was started after the last poll
+    AGS::Engine::MutexLock _lock(_audio_poll_mutex);
+    return in_ms ? channels[channel]->get_pos_ms() : channels[channel]->get_pos();
+}
+
+int audio_channel_get_pos(int channel)
+{
+    return get_channel_position(channel, false);
+}
+
+int audio_channel_get_pos_ms(int channel)
+{
+    return get_channel_position(channel, true);
+}
+
+void audio_channel_clip_removed(int channel)
+{
+    channel_generation[channel]++;
+    pending_seeks[channel].Seq = 0;
+}
+
+void apply_audio_commands()
+{
+    int tail = audio_command_tail;
+    while (tail != audio_command_head)
+    {
+        // Read the command only after seeing it published
+        AGS_MEMORY_BARRIER();
+        const AudioCommand &cmd = audio_commands[tail];
+        // Drop commands for the clips which have left the channel since
+        if ((channels[cmd.Channel] == cmd.Clip) && (channel_generation[cmd.Channel] == cmd.Generation))
+            apply_audio_command(cmd.Clip, cmd.Type, cmd.Value);
+        audio_command_applied = cmd.Seq;
+        tail = (tail + 1) % AudioCommandQueueSize;
+        // Free the slot only after the command was read
+        AGS_MEMORY_BARRIER();
+        audio_command_tail = tail;
+    }
+}
+
+void publish_audio_channel_state(int channel)
+{
+    SOUNDCLIP *clip = channels[channel];
+    const int pos = clip->get_pos();
+    const int pos_ms = clip->get_pos_ms();
+
+    ChannelSnapshot &snap = channel_snapshots[channel];
+    snap.Version++;
+    AGS_MEMORY_BARRIER();
+    snap.Clip = clip;
+    snap.Generation = channel_generation[channel];
+    snap.Pos = pos;
+    snap.PosMs = pos_ms;
+    AGS_MEMORY_BARRIER();
+    snap.Version++;
+}
@@ -0,0 +1,52 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Channel operations passed from the game thread to the audio thread.
+//
+// When audio runs on its own thread, the script's volume, panning and seek
+// requests are put into a lock-free queue which the audio thread applies
+// before polling, and the audio thread publishes clip positions back after
+// every poll. Without the audio thread all the operations are done
+// immediately.
+//
+// The engine's own volume changes (music crossfade, the volume drop while
+// speech plays, ambient and directional sounds), pausing and restoring
+// a saved game still change the clips directly, holding the poll lock.
+//
+//=============================================================================
+#ifndef __AC_AUDIOCOMMANDS_H
+#define __AC_AUDIOCOMMANDS_H
+
+// Game thread functions; the channel must have a clip
+//
+// Sets absolute volume (0-255) of the channel's clip, like SOUNDCLIP::set_volume
+void audio_channel_set_volume(int channel, int volume);
+// Sets panning (0-255) of the channel's clip, like SOUNDCLIP::set_panning
+void audio_channel_set_panning(int channel, int panning);
+void audio_channel_seek(int channel, int position);
+int  audio_channel_get_pos(int channel);
+int  audio_channel_get_pos_ms(int channel);
+// Marks that the channel's clip is about to be deleted, so that the
+// commands posted for it are dropped; must be called with the poll lock held
+void audio_channel_clip_removed(int channel);
+
+// Audio thread functions, called with the poll lock held
+//
+// Applies the queued commands to the clips; the game thread may call this
+// too, when the queue is full
+void apply_audio_commands();
+// Records the position of the channel's clip after it was polled
+void publish_audio_channel_state(int channel);
+
+#endif // __AC_AUDIOCOMMANDS_H
@@ -126,6 +126,8 @@ void MYMP3::destroy()
 
 	_lock.Release();
 
+    // Wake the audio thread up to do the destruction
+    audio_thread_notify();
     while (!done)
       AGSPlatformDriver::GetDriver()->YieldCPU();
 }
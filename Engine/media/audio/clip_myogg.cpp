@@ -115,6 +115,8 @@ void MYOGG::destroy()
 
 	_lock.Release();
 
+    // Wake the audio thread up to do the destruction
+    audio_thread_notify();
     while (!done)
       AGSPlatformDriver::GetDriver()->YieldCPU();
 }
@@ -24,6 +24,7 @@
 #include "platform/base/agsplatformdriver.h"
 
 extern int our_eip;
+extern int audio_stream_buffer_size; // defined in sound.cpp
 
 // ALMP3 functions are not reentrant! This mutex should be locked before calling any
 // of the mp3 functions and unlocked afterwards.
@@ -107,6 +108,8 @@ void MYSTATICMP3::destroy()
 
 	_lock.Release();
 
+    // Wake the audio thread up to do the destruction
+    audio_thread_notify();
     while (!done)
       AGSPlatformDriver::GetDriver()->YieldCPU();
 
@@ -144,7 +147,7 @@ void MYSTATICMP3::restart()
         AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
         almp3_stop_mp3(tune);
         almp3_rewind_mp3(tune);
-        almp3_play_mp3(tune, 16384, vol, panning);
+        almp3_play_mp3(tune, audio_stream_buffer_size, vol, panning);
 		_lockMp3.Release();
         done = 0;
 
@@ -166,7 +169,7 @@ int MYSTATICMP3::get_sound_type() {
 
 int MYSTATICMP3::play() {
     AGS::Engine::MutexLock _lockMp3(_mp3_mutex);
-    int result = almp3_play_ex_mp3(tune, 16384, vol, panning, 1000, repeat);
+    int result = almp3_play_ex_mp3(tune, audio_stream_buffer_size, vol, panning, 1000, repeat);
 	_lockMp3.Release();
 
     if (result != ALMP3_OK) {
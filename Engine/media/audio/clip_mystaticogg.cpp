@@ -28,6 +28,7 @@ extern "C" {
 }
 
 extern int use_extra_sound_offset;  // defined in ac.cpp
+extern int audio_stream_buffer_size; // defined in sound.cpp
 
 int MYSTATICOGG::poll()
 {
@@ -94,6 +95,8 @@ void MYSTATICOGG::destroy()
 
 	_lock.Release();
 
+    // Wake the audio thread up to do the destruction
+    audio_thread_notify();
     while (!done)
       AGSPlatformDriver::GetDriver()->YieldCPU();
 
@@ -176,7 +179,7 @@ void MYSTATICOGG::restart()
     if (tune != NULL) {
         alogg_stop_ogg(tune);
         alogg_rewind_ogg(tune);
-        alogg_play_ogg(tune, 16384, vol, panning);
+        alogg_play_ogg(tune, audio_stream_buffer_size, vol, panning);
         last_ms_offs = 0;
         last_but_one = 0;
         last_but_one_but_one = 0;
@@ -202,11 +205,11 @@ int MYSTATICOGG::get_sound_type() {
 int MYSTATICOGG::play_from(int position)
 {
     if (use_extra_sound_offset) 
-        extraOffset = ((16384 / (alogg_get_wave_is_stereo_ogg(tune) ? 2 : 1)) * 1000) / alogg_get_wave_freq_ogg(tune);
+        extraOffset = ((audio_stream_buffer_size / (alogg_get_wave_is_stereo_ogg(tune) ? 2 : 1)) * 1000) / alogg_get_wave_freq_ogg(tune);
     else
         extraOffset = 0;
 
-    if (alogg_play_ex_ogg(tune, 16384, vol, panning, 1000, repeat) != ALOGG_OK) {
+    if (alogg_play_ex_ogg(tune, audio_stream_buffer_size, vol, panning, 1000, repeat) != ALOGG_OK) {
         destroy();
         delete this;
         return 0;
@@ -69,10 +69,18 @@ void MYWAVE::set_volume(int newvol)
     }
 }
 
+// Stops only this clip's own voice; the sample may be shared with other
+// clips playing from the sound cache, and stop_sample would stop them all
+void MYWAVE::stop_voice()
+{
+    if ((voice >= 0) && (wave != NULL) && (voice_check(voice) == wave))
+        deallocate_voice(voice);
+}
+
 void MYWAVE::internal_destroy()
 {
     // Stop sound and decrease reference count.
-    stop_sample(wave);
+    stop_voice();
     sound_cache_free((char*)wave, true);
     wave = NULL;
 
@@ -91,17 +99,23 @@ void MYWAVE::destroy()
 
 	_lock.Release();
 
+    // Wake the audio thread up to do the destruction
+    audio_thread_notify();
     while (!done)
       AGSPlatformDriver::GetDriver()->YieldCPU();
 }
 
 void MYWAVE::seek(int pos)
 {
+    if ((sourceType != MUS_WAVE) && (wave != NULL))
+        pos = (pos / 10) * (wave->freq / 100);
     voice_set_position(voice, pos);
 }
 
 int MYWAVE::get_pos()
 {
+    if (sourceType != MUS_WAVE)
+        return get_pos_ms();
     return voice_get_position(voice);
 }
 
@@ -128,7 +142,7 @@ void MYWAVE::restart()
     if (wave != NULL) {
         done = 0;
         paused = 0;
-        stop_sample(wave);
+        stop_voice();
         voice = play_sample(wave, vol, panning, 1000, 0);
     }
 }
@@ -139,7 +153,7 @@ int MYWAVE::get_voice()
 }
 
 int MYWAVE::get_sound_type() {
-    return MUS_WAVE;
+    return sourceType;
 }
 
 int MYWAVE::play() {
@@ -152,4 +166,5 @@ int MYWAVE::play() {
 
 MYWAVE::MYWAVE() : SOUNDCLIP() {
     voice = -1;
+    sourceType = MUS_WAVE;
 }
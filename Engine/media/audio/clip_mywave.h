@@ -24,11 +24,16 @@ struct MYWAVE:public SOUNDCLIP
     int voice;
     int firstTime;
     int repeat;
+    // Type of the file the wave was decoded from; waves decoded from OGG and
+    // MP3 clips report and seek positions in milliseconds, like those clips
+    int sourceType;
 
     int poll();
 
     void set_volume(int newvol);
 
+    void stop_voice();
+
     void internal_destroy();
 
     void destroy();
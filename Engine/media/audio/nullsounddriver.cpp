@@ -0,0 +1,187 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#include "media/audio/nullsounddriver.h"
+
+// Allegro only takes additional drivers at runtime on Unix-like systems
+#if defined(LINUX_VERSION) || defined(MAC_VERSION)
+
+#include <stdlib.h>
+#include "util/wgt2allg.h"
+#include "allegro/internal/aintern.h"
+#include "allegro/platform/aintunix.h"
+
+// Mixing buffer length in sample frames; about 23 ms at 44.1 kHz
+const int NULL_SOUND_BUFFER_FRAMES = 1024;
+
+short *null_sound_buffer = NULL;
+bool null_sound_realtime = true;
+bool null_sound_installed = false;
+
+int null_sound_detect(int input);
+int null_sound_init(int input, int voices);
+void null_sound_exit(int input);
+int null_sound_buffer_size();
+
+DIGI_DRIVER digi_ags_null =
+{
+    DIGI_AGS_NULL,
+    "AGS null",
+    "Headless mixer without sound output",
+    "AGS null",
+    0, 0, MIXER_MAX_SFX, MIXER_DEF_SFX,
+
+    null_sound_detect,
+    null_sound_init,
+    null_sound_exit,
+    NULL,
+    NULL,
+
+    NULL,
+    NULL,
+    null_sound_buffer_size,
+    _mixer_init_voice,
+    _mixer_release_voice,
+    _mixer_start_voice,
+    _mixer_stop_voice,
+    _mixer_loop_voice,
+
+    _mixer_get_position,
+    _mixer_set_position,
+
+    _mixer_get_volume,
+    _mixer_set_volume,
+    _mixer_ramp_volume,
+    _mixer_stop_volume_ramp,
+
+    _mixer_get_frequency,
+    _mixer_set_frequency,
+    _mixer_sweep_frequency,
+    _mixer_stop_frequency_sweep,
+
+    _mixer_get_pan,
+    _mixer_set_pan,
+    _mixer_sweep_pan,
+    _mixer_stop_pan_sweep,
+
+    _mixer_set_echo,
+    _mixer_set_tremolo,
+    _mixer_set_vibrato,
+
+    0, 0,
+    NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+void null_sound_timer_callback()
+{
+    null_sound_driver_mix();
+}
+
+int null_sound_detect(int input)
+{
+    return input ? FALSE : TRUE;
+}
+
+int null_sound_init(int input, int voices)
+{
+    if (input)
+        return -1;
+
+    _sound_bits = 16;
+    _sound_stereo = TRUE;
+    if (_sound_freq <= 0)
+        _sound_freq = 44100;
+
+    digi_ags_null.voices = voices;
+    if (_mixer_init(NULL_SOUND_BUFFER_FRAMES * 2, _sound_freq, TRUE, TRUE, &digi_ags_null.voices) != 0)
+        return -1;
+    null_sound_buffer = (short*)malloc(NULL_SOUND_BUFFER_FRAMES * 2 * sizeof(short));
+    if (null_sound_buffer == NULL)
+    {
+        _mixer_exit();
+        return -1;
+    }
+    null_sound_installed = true;
+
+    // Play the buffers at the rate a sound card would
+    if (null_sound_realtime)
+        install_int_ex(null_sound_timer_callback, BPS_TO_TIMER(_sound_freq / NULL_SOUND_BUFFER_FRAMES));
+    return 0;
+}
+
+void null_sound_exit(int input)
+{
+    if (input)
+        return;
+    if (null_sound_realtime)
+        remove_int(null_sound_timer_callback);
+    null_sound_installed = false;
+    _mixer_exit();
+    free(null_sound_buffer);
+    null_sound_buffer = NULL;
+}
+
+int null_sound_buffer_size()
+{
+    return NULL_SOUND_BUFFER_FRAMES;
+}
+
+bool register_null_sound_driver(bool realtime)
+{
+    null_sound_realtime = realtime;
+    _unix_register_digi_driver(DIGI_AGS_NULL, &digi_ags_null, FALSE, FALSE);
+    return true;
+}
+
+bool null_sound_driver_mix()
+{
+    if (!null_sound_installed)
+        return false;
+    _mix_some_samples((uintptr_t)null_sound_buffer, 0, TRUE);
+    return true;
+}
+
+int null_sound_driver_buffer_frames()
+{
+    return NULL_SOUND_BUFFER_FRAMES;
+}
+
+int null_sound_driver_frequency()
+{
+    return _sound_freq;
+}
+
+#else // !LINUX_VERSION && !MAC_VERSION
+
+bool register_null_sound_driver(bool realtime)
+{
+    return false;
+}
+
+bool null_sound_driver_mix()
+{
+    return false;
+}
+
+int null_sound_driver_buffer_frames()
+{
+    return 0;
+}
+
+int null_sound_driver_frequency()
+{
+    return 0;
+}
+
+#endif // LINUX_VERSION || MAC_VERSION
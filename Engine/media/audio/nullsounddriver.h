@@ -0,0 +1,41 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// Headless digital sound driver.
+//
+// Mixes the playing voices with Allegro's software mixer into a buffer in
+// memory, which is thrown away. By default the mixing is paced by a timer,
+// as if a sound card was playing the buffers, so that the game runs the same
+// as with real sound; benchmarks may turn the timer off and mix the buffers
+// themselves as fast as they can.
+//
+//=============================================================================
+#ifndef __AC_NULLSOUNDDRIVER_H
+#define __AC_NULLSOUNDDRIVER_H
+
+// Allegro driver ID of the null driver
+#define DIGI_AGS_NULL AL_ID('A','N','U','L')
+
+// Registers the driver with Allegro, so that it may be installed with
+// install_sound; returns false if drivers cannot be added on this platform
+bool register_null_sound_driver(bool realtime);
+// Mixes the next buffer of the playing voices; returns false if the driver
+// is not installed
+bool null_sound_driver_mix();
+// Number of sample frames mixed into every buffer
+int  null_sound_driver_buffer_frames();
+// Mixing frequency of the installed driver
+int  null_sound_driver_frequency();
+
+#endif // __AC_NULLSOUNDDRIVER_H
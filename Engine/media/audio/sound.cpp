@@ -55,6 +55,9 @@ int numSoundChannels = 8;
 
 
 int use_extra_sound_offset = 0;
+// Size of the buffers which the preloaded OGG and MP3 clips are decoded
+// into while playing, in samples of all channels
+int audio_stream_buffer_size = 16384;
 
 
 
@@ -86,6 +89,18 @@ SOUNDCLIP *my_load_wave(const char *filename, int voll, int loop)
     return thiswave;
 }
 
+// Creates a clip playing the decoded sample of an OGG or MP3 file
+SOUNDCLIP *my_load_decoded_sound(SAMPLE *sample, int sourceType, int voll, bool loop)
+{
+    MYWAVE *wave = new MYWAVE();
+    wave->wave = sample;
+    wave->sourceType = sourceType;
+    wave->vol = voll;
+    wave->firstTime = 1;
+    wave->repeat = loop;
+    return wave;
+}
+
 PACKFILE *mp3in;
 
 #ifndef NO_MP3_PLAYER
@@ -132,21 +147,25 @@ SOUNDCLIP *my_load_mp3(const char *filname, int voll)
 
 
 
-MYSTATICMP3 *thismp3;
 SOUNDCLIP *my_load_static_mp3(const char *filname, int voll, bool loop)
 {
+    SAMPLE *decoded = get_decoded_sound(filname);
+    if (decoded != NULL)
+        return my_load_decoded_sound(decoded, MUS_MP3, voll, loop);
+
     // Load via soundcache.
     long muslen = 0;
     char* mp3buffer = get_cached_sound(filname, false, &muslen);
     if (mp3buffer == NULL)
         return NULL;
 
+    return my_load_static_mp3_from_buffer(filname, mp3buffer, muslen, voll, loop);
+}
+
+SOUNDCLIP *my_load_static_mp3_from_buffer(const char *filname, char *mp3buffer, long muslen, int voll, bool loop)
+{
     // now, create an MP3 structure for it
-    thismp3 = new MYSTATICMP3();
-    if (thismp3 == NULL) {
-        free(mp3buffer);
-        return NULL;
-    }
+    MYSTATICMP3 *thismp3 = new MYSTATICMP3();
     thismp3->vol = voll;
     thismp3->mp3buffer = NULL;
     thismp3->repeat = loop;
@@ -158,13 +177,25 @@ SOUNDCLIP *my_load_static_mp3(const char *filname, int voll, bool loop)
     thismp3->ready = true;
 
     if (thismp3->tune == NULL) {
-        free(mp3buffer);
+        sound_cache_free(mp3buffer, false);
         delete thismp3;
         return NULL;
     }
 
     thismp3->mp3buffer = mp3buffer;
 
+    _lockMp3.Acquire(_mp3_mutex);
+    SAMPLE *decoded = NULL;
+    if (should_decode_sound(almp3_get_length_msecs_mp3(thismp3->tune)))
+        decoded = almp3_create_sample_from_mp3(thismp3->tune);
+    _lockMp3.Release();
+    if (decoded != NULL)
+    {
+        thismp3->destroy();
+        delete thismp3;
+        return my_load_decoded_sound(put_decoded_sound(filname, decoded), MUS_MP3, voll, loop);
+    }
+
     return thismp3;
 }
 
@@ -180,21 +211,35 @@ SOUNDCLIP *my_load_static_mp3(const char *filname, int voll, bool loop)
     return NULL;
 }
 
+SOUNDCLIP *my_load_static_mp3_from_buffer(const char *filname, char *mp3buffer, long muslen, int voll, bool loop)
+{
+    sound_cache_free(mp3buffer, false);
+    return NULL;
+}
+
 #endif // NO_MP3_PLAYER
 
 
 
-MYSTATICOGG *thissogg;
 SOUNDCLIP *my_load_static_ogg(const char *filname, int voll, bool loop)
 {
+    SAMPLE *decoded = get_decoded_sound(filname);
+    if (decoded != NULL)
+        return my_load_decoded_sound(decoded, MUS_OGG, voll, loop);
+
     // Load via soundcache.
     long muslen = 0;
     char* mp3buffer = get_cached_sound(filname, false, &muslen);
     if (mp3buffer == NULL)
         return NULL;
 
+    return my_load_static_ogg_from_buffer(filname, mp3buffer, muslen, voll, loop);
+}
+
+SOUNDCLIP *my_load_static_ogg_from_buffer(const char *filname, char *mp3buffer, long muslen, int voll, bool loop)
+{
     // now, create an OGG structure for it
-    thissogg = new MYSTATICOGG();
+    MYSTATICOGG *thissogg = new MYSTATICOGG();
     thissogg->vol = voll;
     thissogg->repeat = loop;
     thissogg->done = 0;
@@ -210,6 +255,16 @@ SOUNDCLIP *my_load_static_ogg(const char *filname, int voll, bool loop)
         return NULL;
     }
 
+    SAMPLE *decoded = NULL;
+    if (should_decode_sound(alogg_get_length_msecs_ogg(thissogg->tune)))
+        decoded = alogg_create_sample_from_ogg(thissogg->tune);
+    if (decoded != NULL)
+    {
+        thissogg->destroy();
+        delete thissogg;
+        return my_load_decoded_sound(put_decoded_sound(filname, decoded), MUS_OGG, voll, loop);
+    }
+
     return thissogg;
 }
 
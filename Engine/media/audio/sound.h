@@ -25,11 +25,18 @@ SOUNDCLIP *my_load_wave(const char *filename, int voll, int loop);
 SOUNDCLIP *my_load_mp3(const char *filname, int voll);
 SOUNDCLIP *my_load_static_mp3(const char *filname, int voll, bool loop);
 SOUNDCLIP *my_load_static_ogg(const char *filname, int voll, bool loop);
+// Create clips from the file data already in memory; the buffer must come from
+// the sound cache or be allocated with malloc, and is owned by the clip after
+// the call. Short clips are decoded and put into the decoded sound cache under
+// the file name. These may be called from any thread.
+SOUNDCLIP *my_load_static_mp3_from_buffer(const char *filname, char *mp3buffer, long muslen, int voll, bool loop);
+SOUNDCLIP *my_load_static_ogg_from_buffer(const char *filname, char *mp3buffer, long muslen, int voll, bool loop);
 SOUNDCLIP *my_load_ogg(const char *filname, int voll);
 SOUNDCLIP *my_load_midi(const char *filname, int repet);
 SOUNDCLIP *my_load_mod(const char *filname, int repet);
 
 extern int numSoundChannels;
 extern int use_extra_sound_offset;
+extern int audio_stream_buffer_size;
 
 #endif // __AC_SOUND_H
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "util/wgt2allg.h"
+#include "ac/gamesetup.h"
 #include "media/audio/soundcache.h"
 #include "media/audio/audiointernaldefs.h"
 #include "util/mutex.h"
@@ -25,6 +26,112 @@ unsigned int sound_cache_counter = 0;
 
 AGS::Engine::Mutex _sound_cache_mutex;
 
+extern GameSetup usetup;
+
+typedef struct decoded_sound_entry_s
+{
+    char* file_name;
+    unsigned int hash;
+    SAMPLE* sample;
+    unsigned int size;
+    int reference;
+    struct decoded_sound_entry_s* hash_next;
+    struct decoded_sound_entry_s* lru_prev; // used more recently
+    struct decoded_sound_entry_s* lru_next; // used less recently
+} decoded_sound_entry_t;
+
+const int DECODED_SOUND_HASH_SIZE = 64;
+decoded_sound_entry_t* decoded_sound_hash[DECODED_SOUND_HASH_SIZE];
+decoded_sound_entry_t* decoded_sound_lru_first = NULL;
+decoded_sound_entry_t* decoded_sound_lru_last = NULL;
+unsigned int decoded_sound_cache_used = 0;
+
+unsigned int get_file_name_hash(const char* filename)
+{
+    // FNV-1a
+    unsigned int hash = 2166136261u;
+    for (; *filename; filename++)
+    {
+        hash ^= (unsigned char)*filename;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void unlink_decoded_sound_lru(decoded_sound_entry_t* entry)
+{
+    if (entry->lru_prev)
+        entry->lru_prev->lru_next = entry->lru_next;
+    else
+        decoded_sound_lru_first = entry->lru_next;
+    if (entry->lru_next)
+        entry->lru_next->lru_prev = entry->lru_prev;
+    else
+        decoded_sound_lru_last = entry->lru_prev;
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+void link_decoded_sound_lru_first(decoded_sound_entry_t* entry)
+{
+    entry->lru_prev = NULL;
+    entry->lru_next = decoded_sound_lru_first;
+    if (decoded_sound_lru_first)
+        decoded_sound_lru_first->lru_prev = entry;
+    else
+        decoded_sound_lru_last = entry;
+    decoded_sound_lru_first = entry;
+}
+
+void free_decoded_sound(decoded_sound_entry_t* entry)
+{
+    decoded_sound_entry_t** link = &decoded_sound_hash[entry->hash % DECODED_SOUND_HASH_SIZE];
+    while (*link != entry)
+        link = &(*link)->hash_next;
+    *link = entry->hash_next;
+    unlink_decoded_sound_lru(entry);
+
+    decoded_sound_cache_used -= entry->size;
+    destroy_sample(entry->sample);
+    free(entry->file_name);
+    free(entry);
+}
+
+void clear_decoded_sound_cache()
+{
+    while (decoded_sound_lru_first)
+        free_decoded_sound(decoded_sound_lru_first);
+}
+
+// Finds the decoded sample of the file; must be called with the cache mutex locked
+decoded_sound_entry_t* find_decoded_sound(const char* filename)
+{
+    unsigned int hash = get_file_name_hash(filename);
+    decoded_sound_entry_t* entry = decoded_sound_hash[hash % DECODED_SOUND_HASH_SIZE];
+    for (; entry; entry = entry->hash_next)
+    {
+        if (entry->hash == hash && strcmp(filename, entry->file_name) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+// Decreases the reference count of the decoded sample; returns false if the
+// sample is not cached. Must be called with the cache mutex locked
+bool release_decoded_sound(SAMPLE* sample)
+{
+    for (decoded_sound_entry_t* entry = decoded_sound_lru_first; entry; entry = entry->lru_next)
+    {
+        if (entry->sample == sample)
+        {
+            if (entry->reference > 0)
+                entry->reference--;
+            return true;
+        }
+    }
+    return false;
+}
+
 
 void clear_sound_cache()
 {
@@ -50,6 +157,8 @@ void clear_sound_cache()
         sound_cache_entries = (sound_cache_entry_t*)malloc(psp_audio_cachesize * sizeof(sound_cache_entry_t));
         memset(sound_cache_entries, 0, psp_audio_cachesize * sizeof(sound_cache_entry_t));
     }
+
+    clear_decoded_sound_cache();
 }
 
 void sound_cache_free(char* buffer, bool is_wave)
@@ -74,6 +183,9 @@ void sound_cache_free(char* buffer, bool is_wave)
         }
     }
 
+    if (is_wave && release_decoded_sound((SAMPLE*)buffer))
+        return;
+
 #ifdef SOUND_CACHE_DEBUG
     Out::FPrint("..freeing uncached sound\n");
 #endif
@@ -89,18 +201,11 @@ void sound_cache_free(char* buffer, bool is_wave)
 }
 
 
-char* get_cached_sound(const char* filename, bool is_wave, long* size)
+// Finds the cached data of the file and references it; must be called with
+// the cache mutex locked
+char* find_cached_sound(const char* filename, long* size)
 {
-	AGS::Engine::MutexLock _lock(_sound_cache_mutex);
-
-#ifdef SOUND_CACHE_DEBUG
-    Out::FPrint("get_cached_sound(%s %d)\n", filename, (unsigned int)is_wave);
-#endif
-
-    *size = 0;
-
-    int i;
-    for (i = 0; i < psp_audio_cachesize; i++)
+    for (int i = 0; i < psp_audio_cachesize; i++)
     {
         if (sound_cache_entries[i].data == NULL)
             continue;
@@ -117,29 +222,14 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
             return sound_cache_entries[i].data;
         }
     }
+    return NULL;
+}
 
-    // Not found
-    PACKFILE *mp3in = NULL;
-    SAMPLE* wave = NULL;
-
-    if (is_wave)
-    {
-        PACKFILE *wavin = pack_fopen(filename, "rb");
-        if (wavin != NULL)
-        {
-            wave = load_wav_pf(wavin);
-            pack_fclose(wavin);
-        }
-    }  
-    else
-    {
-        mp3in = pack_fopen(filename, "rb");
-        if (mp3in == NULL)
-        {
-            return NULL;
-        }
-    }
-
+// Puts loaded data in a free or the least recently used slot, if there is one;
+// must be called with the cache mutex locked
+char* store_cached_sound(const char* filename, char* newdata, long size, bool is_wave)
+{
+    int i;
     // Find free slot
     for (i = 0; i < psp_audio_cachesize; i++)
     {
@@ -168,29 +258,6 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
         i = index;
     }
 
-    // Load new file
-    char* newdata;
-
-    if (is_wave)
-    {
-        *size = 0;
-        newdata = (char*)wave;
-    }
-    else
-    {
-        *size = mp3in->todo;
-        newdata = (char *)malloc(*size);
-
-        if (newdata == NULL)
-        {
-            pack_fclose(mp3in);
-            return NULL;
-        }
-
-        pack_fread(newdata, *size, mp3in);
-        pack_fclose(mp3in);
-    }
-
     if (i == -1)
     {
         // No cache slot empty, return uncached data
@@ -213,7 +280,7 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
                 free(sound_cache_entries[i].data);
 	}
 	
-        sound_cache_entries[i].size = *size;
+        sound_cache_entries[i].size = size;
         sound_cache_entries[i].data = newdata;
 
         if (sound_cache_entries[i].file_name)
@@ -226,5 +293,163 @@ char* get_cached_sound(const char* filename, bool is_wave, long* size)
 
         return sound_cache_entries[i].data;	
     }
+}
+
+bool is_sound_cached(const char* filename)
+{
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+
+    for (int i = 0; i < psp_audio_cachesize; i++)
+    {
+        if (sound_cache_entries[i].data != NULL &&
+            strcmp(filename, sound_cache_entries[i].file_name) == 0)
+            return true;
+    }
+    return find_decoded_sound(filename) != NULL;
+}
+
+char* put_sound_to_cache(const char* filename, char* data, long size)
+{
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+
+    // The file may have been loaded by someone else in the meantime
+    long cached_size;
+    char* cached = find_cached_sound(filename, &cached_size);
+    if (cached != NULL)
+    {
+        free(data);
+        return cached;
+    }
+    return store_cached_sound(filename, data, size, false);
+}
+
+char* get_cached_sound(const char* filename, bool is_wave, long* size)
+{
+	AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+
+#ifdef SOUND_CACHE_DEBUG
+    Out::FPrint("get_cached_sound(%s %d)\n", filename, (unsigned int)is_wave);
+#endif
+
+    *size = 0;
+
+    char* cached = find_cached_sound(filename, size);
+    if (cached != NULL)
+        return cached;
+
+    // Not found
+    PACKFILE *mp3in = NULL;
+    SAMPLE* wave = NULL;
+
+    if (is_wave)
+    {
+        PACKFILE *wavin = pack_fopen(filename, "rb");
+        if (wavin != NULL)
+        {
+            wave = load_wav_pf(wavin);
+            pack_fclose(wavin);
+        }
+    }  
+    else
+    {
+        mp3in = pack_fopen(filename, "rb");
+        if (mp3in == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    // Load new file
+    char* newdata;
+
+    if (is_wave)
+    {
+        *size = 0;
+        newdata = (char*)wave;
+    }
+    else
+    {
+        *size = mp3in->todo;
+        newdata = (char *)malloc(*size);
+
+        if (newdata == NULL)
+        {
+            pack_fclose(mp3in);
+            return NULL;
+        }
+
+        pack_fread(newdata, *size, mp3in);
+        pack_fclose(mp3in);
+    }
+
+    return store_cached_sound(filename, newdata, *size, is_wave);
+}
+
+bool should_decode_sound(int length_ms)
+{
+    return (usetup.decoded_sound_cache_size > 0) && (length_ms > 0) &&
+        (length_ms <= usetup.decoded_sound_max_length);
+}
+
+SAMPLE* get_decoded_sound(const char* filename)
+{
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+
+    decoded_sound_entry_t* entry = find_decoded_sound(filename);
+    if (entry == NULL)
+        return NULL;
+    entry->reference++;
+    unlink_decoded_sound_lru(entry);
+    link_decoded_sound_lru_first(entry);
+    return entry->sample;
+}
+
+SAMPLE* put_decoded_sound(const char* filename, SAMPLE* sample)
+{
+    AGS::Engine::MutexLock _lock(_sound_cache_mutex);
+
+    // The file may have been decoded by someone else in the meantime
+    decoded_sound_entry_t* entry = find_decoded_sound(filename);
+    if (entry != NULL)
+    {
+        destroy_sample(sample);
+        entry->reference++;
+        unlink_decoded_sound_lru(entry);
+        link_decoded_sound_lru_first(entry);
+        return entry->sample;
+    }
+
+    const unsigned int size = sample->len * (sample->bits / 8) * (sample->stereo ? 2 : 1);
+    const unsigned int budget = (unsigned int)usetup.decoded_sound_cache_size;
+    if (size > budget)
+        return sample;
+    // Free the least recently used samples which are not playing
+    decoded_sound_entry_t* victim = decoded_sound_lru_last;
+    while (victim && decoded_sound_cache_used + size > budget)
+    {
+        decoded_sound_entry_t* prev = victim->lru_prev;
+        if (victim->reference == 0)
+            free_decoded_sound(victim);
+        victim = prev;
+    }
+    if (decoded_sound_cache_used + size > budget)
+    {
+#ifdef SOUND_CACHE_DEBUG
+        Out::FPrint("..decoded sound cache is full, %s stays uncached\n", filename);
+#endif
+        return sample;
+    }
 
+    entry = (decoded_sound_entry_t*)malloc(sizeof(decoded_sound_entry_t));
+    entry->file_name = (char*)malloc(strlen(filename) + 1);
+    strcpy(entry->file_name, filename);
+    entry->hash = get_file_name_hash(filename);
+    entry->sample = sample;
+    entry->size = size;
+    entry->reference = 1;
+    entry->hash_next = decoded_sound_hash[entry->hash % DECODED_SOUND_HASH_SIZE];
+    decoded_sound_hash[entry->hash % DECODED_SOUND_HASH_SIZE] = entry;
+    link_decoded_sound_lru_first(entry);
+    decoded_sound_cache_used += size;
+    return sample;
 }
@@ -47,6 +47,28 @@ extern int psp_midi_preload_patches;
 void clear_sound_cache();
 void sound_cache_free(char* buffer, bool is_wave);
 char* get_cached_sound(const char* filename, bool is_wave, long* size);
+// Tells whether the file's data is currently in the cache
+bool is_sound_cached(const char* filename);
+// Puts file data read elsewhere into the cache and returns the buffer to use
+// instead of it, which is referenced like get_cached_sound result; data must
+// be allocated with malloc. Safe to call from any thread.
+char* put_sound_to_cache(const char* filename, char* data, long size);
+
+// Decoded sound cache: short OGG and MP3 clips are decoded fully into
+// samples, which are played as waves and shared by all the playbacks of
+// the clip. The samples are found by the file name hash, and the least
+// recently used of those not playing are freed when the cache is over its
+// memory budget. Samples are released with sound_cache_free(sample, true).
+struct SAMPLE;
+// Tells whether a clip of the given length should be decoded into the cache
+bool should_decode_sound(int length_ms);
+// Finds the decoded sample of the file and references it; returns NULL if
+// the file has not been decoded
+SAMPLE* get_decoded_sound(const char* filename);
+// Puts a decoded sample into the cache and returns the sample to use instead
+// of it; the sample is returned uncached if it does not fit in the budget.
+// Safe to call from any thread.
+SAMPLE* put_decoded_sound(const char* filename, SAMPLE* sample);
 
 
 #endif // __AC_SOUNDCACHE_H
@@ -25,6 +25,8 @@
 // JJS: This is needed for the derieved classes
 extern volatile int psp_audio_multithreaded;
 extern volatile bool _audio_doing_crossfade;
+// Makes the audio thread poll the clips without waiting for its next turn
+void audio_thread_notify();
 
 struct SOUNDCLIP
 {
@@ -112,7 +114,7 @@ struct SOUNDCLIP
     }
 
     SOUNDCLIP();
-    ~SOUNDCLIP();
+    virtual ~SOUNDCLIP();
 };
 
 
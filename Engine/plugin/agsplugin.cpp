@@ -35,8 +35,10 @@
 #include "ac/parser.h"
 #include "ac/record.h"
 #include "ac/roomstatus.h"
+#include "ac/route_finder.h"
 #include "ac/string.h"
 #include "font/fonts.h"
+#include "font/textlayoutcache.h"
 #include "util/string_utils.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
@@ -418,7 +420,11 @@ BITMAP *IAGSEngine::GetSpriteGraphic (int32 num) {
 }
 BITMAP *IAGSEngine::GetRoomMask (int32 index) {
     if (index == MASK_WALKABLE)
+    {
+        // the plugin may change the walkable areas
+        reset_room_route_data();
         return (BITMAP*)thisroom.walls->GetAllegroBitmap();
+    }
     else if (index == MASK_WALKBEHIND)
         return (BITMAP*)thisroom.object->GetAllegroBitmap();
     else if (index == MASK_HOTSPOT)
@@ -790,6 +796,7 @@ IAGSFontRenderer* IAGSEngine::ReplaceFontRenderer(int fontNumber, IAGSFontRender
 {
     IAGSFontRenderer* oldOne = fontRenderers[fontNumber];
     fontRenderers[fontNumber] = newRenderer;
+    invalidate_text_layout_cache(fontNumber);
     return oldOne;
 }
 
@@ -837,6 +844,14 @@ int pl_run_plugin_hooks (int event, long data) {
     return 0;
 }
 
+bool pl_any_want_hook (int event) {
+    for (int i = 0; i < numPlugins; i++) {
+        if (plugins[i].wantHook & event)
+            return true;
+    }
+    return false;
+}
+
 int pl_run_plugin_debug_hooks (const char *scriptfile, int linenum) {
     int i, retval = 0;
     for (i = 0; i < numPlugins; i++) {
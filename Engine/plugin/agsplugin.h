@@ -578,6 +578,8 @@ using namespace AGS; // FIXME later
 void pl_stop_plugins();
 void pl_startup_plugins();
 int  pl_run_plugin_hooks (int event, long data);
+// Tells whether any plugin has requested the event
+bool pl_any_want_hook (int event);
 void pl_run_plugin_init_gfx_hooks(const char *driverName, void *data);
 int  pl_run_plugin_debug_hooks (const char *scriptfile, int linenum);
 void pl_read_plugins_from_disk (Common::Stream *in);
@@ -24,6 +24,7 @@
 #include "script/cc_instance.h"
 #include "debug/debug_log.h"
 #include "debug/out.h"
+#include "debug/tracer.h"
 #include "script/cc_options.h"
 #include "script/executingscript.h"
 #include "script/script.h"
@@ -287,6 +288,7 @@ void ccInstance::AbortAndDestroy()
 
 int ccInstance::CallScriptFunction(char *funcname, int32_t numargs, RuntimeScriptValue *params)
 {
+    TraceScope trace("script", funcname);
     ccError = 0;
     currentline = 0;
 
@@ -21,6 +21,7 @@
 #include "ac/event.h"
 #include "ac/game.h"
 #include "ac/gamesetupstruct.h"
+#include "ac/gamesnapshot.h"
 #include "ac/gamestate.h"
 #include "ac/global_audio.h"
 #include "ac/global_character.h"
@@ -356,6 +357,13 @@ void post_script_cleanup() {
     case ePSASaveGameDialog:
         save_game_dialog();
         break;
+    case ePSASaveSnapshot:
+        save_game_snapshot();
+        break;
+    case ePSARestoreSnapshot:
+        cancel_all_scripts();
+        restore_game_snapshot(thisData);
+        return;
     default:
         quitprintf("undefined post script action found: %d", copyof.postScriptActions[ii]);
         }
@@ -0,0 +1,65 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+//
+// High resolution clock, meant for measuring time intervals.
+//
+//=============================================================================
+#ifndef __AGS_EE_UTIL__CLOCK_H
+#define __AGS_EE_UTIL__CLOCK_H
+
+#include "core/types.h"
+
+#if defined(WINDOWS_VERSION)
+// FIXME: This is a horrible hack to avoid conflicts between Allegro and Windows
+#define BITMAP WINDOWS_BITMAP
+#include <windows.h>
+#undef BITMAP
+#elif defined(LINUX_VERSION) || defined(ANDROID_VERSION)
+#include <time.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+
+// Returns current time in microseconds, counted from an arbitrary
+// point in the past; only the difference of two values is meaningful
+inline int64_t GetClockMicroseconds()
+{
+#if defined(WINDOWS_VERSION)
+    static LARGE_INTEGER freq = { 0 };
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    LARGE_INTEGER count;
+    QueryPerformanceCounter(&count);
+    return (int64_t)((count.QuadPart / freq.QuadPart) * 1000000 +
+        ((count.QuadPart % freq.QuadPart) * 1000000) / freq.QuadPart);
+#elif defined(LINUX_VERSION) || defined(ANDROID_VERSION)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#else
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+}
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_UTIL__CLOCK_H
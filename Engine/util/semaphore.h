@@ -0,0 +1,64 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifndef __AGS_EE_UTIL__SEMAPHORE_H
+#define __AGS_EE_UTIL__SEMAPHORE_H
+
+namespace AGS
+{
+namespace Engine
+{
+
+
+// Counting semaphore, used to signal a waiting thread
+class BaseSemaphore
+{
+public:
+  BaseSemaphore()
+  {
+  };
+
+  virtual ~BaseSemaphore()
+  {
+  };
+
+  // Blocks until the counter is positive, then decrements it
+  virtual void Wait() = 0;
+
+  // Same as Wait, but gives up after the given time; returns false if
+  // the time has run out
+  virtual bool WaitTimeout(int timeout_ms) = 0;
+
+  // Increments the counter, waking up one of the waiting threads
+  virtual void Post() = 0;
+};
+
+
+} // namespace Engine
+} // namespace AGS
+
+
+#if defined(WINDOWS_VERSION)
+#include "semaphore_windows.h"
+
+#elif defined(LINUX_VERSION) \
+   || defined(MAC_VERSION) \
+   || defined(IOS_VERSION) \
+   || defined(ANDROID_VERSION)
+#include "semaphore_pthread.h"
+
+#endif
+
+
+#endif // __AGS_EE_UTIL__SEMAPHORE_H
@@ -0,0 +1,96 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifndef __AGS_EE_UTIL__SEMAPHORE_PTHREAD_H
+#define __AGS_EE_UTIL__SEMAPHORE_PTHREAD_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+namespace AGS
+{
+namespace Engine
+{
+
+
+// Unnamed POSIX semaphores are not supported on Mac OS X,
+// so the semaphore is implemented with a condition variable
+class PThreadSemaphore : public BaseSemaphore
+{
+public:
+  inline PThreadSemaphore()
+  {
+    _count = 0;
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_cond, NULL);
+  }
+
+  inline ~PThreadSemaphore()
+  {
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+  }
+
+  inline void Wait()
+  {
+    pthread_mutex_lock(&_mutex);
+    while (_count == 0)
+      pthread_cond_wait(&_cond, &_mutex);
+    _count--;
+    pthread_mutex_unlock(&_mutex);
+  }
+
+  inline bool WaitTimeout(int timeout_ms)
+  {
+    // The wait time is absolute and measured by the system clock
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    long long nsec = (long long)now.tv_usec * 1000 + (long long)(timeout_ms % 1000) * 1000000;
+    struct timespec until;
+    until.tv_sec = now.tv_sec + timeout_ms / 1000 + (time_t)(nsec / 1000000000);
+    until.tv_nsec = (long)(nsec % 1000000000);
+
+    pthread_mutex_lock(&_mutex);
+    int result = 0;
+    while (_count == 0 && result != ETIMEDOUT)
+      result = pthread_cond_timedwait(&_cond, &_mutex, &until);
+    const bool signalled = _count > 0;
+    if (signalled)
+      _count--;
+    pthread_mutex_unlock(&_mutex);
+    return signalled;
+  }
+
+  inline void Post()
+  {
+    pthread_mutex_lock(&_mutex);
+    _count++;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_mutex);
+  }
+
+private:
+  pthread_mutex_t _mutex;
+  pthread_cond_t  _cond;
+  int             _count;
+};
+
+typedef PThreadSemaphore Semaphore;
+
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_UTIL__SEMAPHORE_PTHREAD_H
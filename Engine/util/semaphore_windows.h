@@ -0,0 +1,82 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-20xx others
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// http://www.opensource.org/licenses/artistic-license-2.0.php
+//
+//=============================================================================
+
+#ifndef __AGS_EE_UTIL__WINDOWS_SEMAPHORE_H
+#define __AGS_EE_UTIL__WINDOWS_SEMAPHORE_H
+
+// FIXME: This is a horrible hack to avoid conflicts between Allegro and Windows
+#define BITMAP WINDOWS_BITMAP
+#include <windows.h>
+#undef BITMAP
+
+#include <crtdbg.h>
+#include <limits.h>
+
+
+namespace AGS
+{
+namespace Engine
+{
+
+
+class WindowsSemaphore : public BaseSemaphore
+{
+public:
+  WindowsSemaphore()
+  {
+    _semaphore = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+
+    _ASSERT(_semaphore != NULL);
+  }
+
+  ~WindowsSemaphore()
+  {
+    _ASSERT(_semaphore != NULL);
+
+    CloseHandle(_semaphore);
+  }
+
+  inline void Wait()
+  {
+    _ASSERT(_semaphore != NULL);
+
+    WaitForSingleObject(_semaphore, INFINITE);
+  }
+
+  inline bool WaitTimeout(int timeout_ms)
+  {
+    _ASSERT(_semaphore != NULL);
+
+    return WaitForSingleObject(_semaphore, timeout_ms) == WAIT_OBJECT_0;
+  }
+
+  inline void Post()
+  {
+    _ASSERT(_semaphore != NULL);
+
+    ReleaseSemaphore(_semaphore, 1, NULL);
+  }
+
+private:
+  HANDLE _semaphore;
+};
+
+
+typedef WindowsSemaphore Semaphore;
+
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_UTIL__WINDOWS_SEMAPHORE_H